@@ -0,0 +1,76 @@
+#include "ems_parser.hpp"
+#include "ems_adpcm.hpp"
+#include "ems_dma.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+using namespace ems::literals;
+
+constexpr auto melody = "(120)1,2,3,"_ems;
+constexpr auto arpeggio = "(240)1,3,5,1`,5,3,1,"_ems;
+
+// Minimum signal-to-noise ratio of the decoded output against the int16 render.
+constexpr double minSnrDb = 30.0;
+
+/**
+ * Decodes `clip` through a DMA double buffer, the way the refill interrupt would, and
+ * returns the SNR against `pcm`. Returns -1 if the lengths do not match.
+ */
+template <size_t N>
+static double decodedSnr(const ems::adpcm::Clip<N>& clip, const std::array<int16_t, N>& pcm)
+{
+    ems::adpcm::Decoder decoder(clip);
+    ems::dma::DoubleBuffer<ems::adpcm::Decoder, 128> out(decoder);
+
+    std::vector<int16_t> decoded;
+    out.prime();
+    for (bool first = true; !out.finished(); first = !first)
+    {
+        // DMA 读完一半后交还该半区
+        const int16_t* half = out.data() + (first ? 0 : 128);
+        decoded.insert(decoded.end(), half, half + 128);
+        if (first) out.on_half_transfer();
+        else out.on_transfer_complete();
+    }
+    if (decoded.size() < N) return -1.0;
+
+    double signal = 0.0;
+    double noise = 0.0;
+    for (size_t i = 0; i < N; ++i)
+    {
+        const double d = static_cast<double>(pcm[i]) - decoded[i];
+        signal += static_cast<double>(pcm[i]) * pcm[i];
+        noise += d * d;
+    }
+    for (size_t i = N; i < decoded.size(); ++i)
+    {
+        if (decoded[i] != 0) return -1.0; // 结束后只有静音
+    }
+    return 10.0 * std::log10(signal / noise);
+}
+
+template <size_t N>
+static bool check(const char* name, const uint32_t rate, const ems::adpcm::Clip<N>& clip,
+                  const std::array<int16_t, N>& pcm)
+{
+    const double snr = decodedSnr(clip, pcm);
+    std::printf("%-8s %5u Hz: %zu samples, %zu -> %zu bytes, SNR %.1f dB\n", name, rate, N, sizeof(pcm),
+                clip.data.size(), snr);
+    return snr >= minSnrDb;
+}
+
+// Encodes two melodies to IMA-ADPCM at compile time, decodes them through the DMA path and
+// checks the result against the int16 render.
+int main()
+{
+    static constexpr auto melodyClip = ems::adpcm::render<16000, melody>();
+    static constexpr auto melodyPcm = ems::render<16000, int16_t, melody>();
+    static constexpr auto arpeggioClip = ems::adpcm::render<8000, arpeggio>();
+    static constexpr auto arpeggioPcm = ems::render<8000, int16_t, arpeggio>();
+    static_assert(melodyClip.data.size() * 4 == sizeof(melodyPcm)); // 4 bit / sample
+
+    const bool ok = check("melody", 16000, melodyClip, melodyPcm) & check("arpeggio", 8000, arpeggioClip, arpeggioPcm);
+    if (!ok) std::fprintf(stderr, "ADPCM 解码信噪比低于 %.0f dB\n", minSnrDb);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,96 @@
+#include "ems_parser.hpp"
+#include "Audio.hpp"
+
+#include <cmath>
+#include <cstdio>
+using namespace ems::literals;
+
+// The same four notes, plain and with staccato / accent / tenuto marks.
+constexpr auto marked = "(120)5,5',5>,5=,"_ems_art;
+constexpr auto plain = "(120)5,5,5,5,"_ems;
+constexpr uint32_t sampleRate = 48000;
+
+static_assert(marked.size() == 4);
+static_assert(marked[0].articulation == ems::Articulation::Normal);
+static_assert(marked[1].articulation == ems::Articulation::Staccato);
+static_assert(marked[2].articulation == ems::Articulation::Accent);
+static_assert(marked[3].articulation == ems::Articulation::Tenuto);
+static_assert(marked[1].duration_ms == 500 && marked[1].ratio == plain[1].ratio);
+
+// A mark may also sit before the duration, and `_ems` reads the marks as nothing.
+static_assert("(120)1'-2>,"_ems_art[0].articulation == ems::Articulation::Staccato);
+static_assert("(120)1'-2>,"_ems_art[0].duration_ms == 250);
+static_assert("(120)[1>35]-"_ems_art[0].articulation == ems::Articulation::Accent);
+static_assert("(120)5,5',5>,5=,"_ems[1].duration_ms == plain[1].duration_ms);
+
+struct Shape
+{
+    uint32_t lastSound; // 最后一个非零样本的位置（相对音符起点）
+    float peak;
+};
+
+// Measures note `index` of a generatePCM() render.
+template <typename Container>
+static Shape measure(const std::vector<float>& pcm, const Container& notes, const size_t index)
+{
+    size_t start = 0;
+    for (size_t i = 0; i < index; ++i) start += noteSamples(notes[i].duration_ms, sampleRate) + noteGap(sampleRate);
+    const uint32_t samples = noteSamples(notes[index].duration_ms, sampleRate);
+
+    Shape s{0, 0.0f};
+    for (uint32_t i = 0; i < samples; ++i)
+    {
+        const float v = std::fabs(pcm[start + i]);
+        if (v > 1e-6f) s.lastSound = i;
+        s.peak = std::fmax(s.peak, v);
+    }
+    return s;
+}
+
+// Renders both scores and checks that the marks reach the PCM: staccato stops after
+// half the note, accent peaks 1.5x higher, unmarked notes are unchanged.
+int main()
+{
+    std::vector<float> a;
+    std::vector<float> b;
+    generatePCM(marked, a, sampleRate);
+    generatePCM(plain, b, sampleRate);
+    if (a.size() != b.size())
+    {
+        std::fprintf(stderr, "演奏记号改变了总长度\n");
+        return 1;
+    }
+
+    const uint32_t samples = noteSamples(500, sampleRate);
+    int failed = 0;
+    const char* names[] = {"normal", "staccato", "accent", "tenuto"};
+    for (size_t i = 0; i < 4; ++i)
+    {
+        const Shape m = measure(a, marked, i);
+        const Shape p = measure(b, plain, i);
+        std::printf("%-8s sounds %5u / %u samples (plain %5u), peak %.3f (plain %.3f)\n", names[i], m.lastSound + 1,
+                    samples, p.lastSound + 1, m.peak, p.peak);
+    }
+
+    const Shape normal = measure(a, marked, 0);
+    const Shape staccato = measure(a, marked, 1);
+    const Shape accent = measure(a, marked, 2);
+    const Shape reference = measure(b, plain, 0);
+
+    if (normal.lastSound != reference.lastSound || normal.peak != reference.peak)
+    {
+        std::fprintf(stderr, "无记号的音符与普通渲染不一致\n");
+        failed++;
+    }
+    if (staccato.lastSound >= samples / 2 || staccato.lastSound + 1 < samples / 2 - sampleRate / 1000)
+    {
+        std::fprintf(stderr, "断奏没有在一半时长处结束\n");
+        failed++;
+    }
+    if (std::fabs(accent.peak / reference.peak - 1.5f) > 0.05f)
+    {
+        std::fprintf(stderr, "重音的峰值不是普通音符的 1.5 倍\n");
+        failed++;
+    }
+    return failed == 0 ? 0 : 1;
+}
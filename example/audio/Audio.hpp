@@ -1,6 +1,9 @@
 #ifndef EMS_AUDIO_HPP
 #define EMS_AUDIO_HPP
 
+#include <atomic>
+#include <chrono>
+#include <thread>
 #include <vector>
 #include <cmath>
 #include <cstdint>
@@ -8,6 +11,10 @@
 #include <iostream>
 #include <miniaudio.h>
 
+#include "Envelope.hpp"
+#include "Oscillator.hpp"
+#include "SampleConvert.hpp"
+
 
 struct Note
 {
@@ -15,82 +22,100 @@ struct Note
     uint32_t duration_ms;
 };
 
+// _ems_art 解析出的音符带 articulation 字段，在整段包络基础上调整
+template <typename N>
+static Envelope noteEnvelope(const N& n, const Envelope& fallback)
+{
+    if constexpr (requires { n.articulation; })
+    {
+        return articulate(n.articulation, fallback);
+    }
+    else
+    {
+        return fallback;
+    }
+}
+
+inline uint32_t noteSamples(uint32_t durationMs, uint32_t sampleRate)
+{
+    return static_cast<uint32_t>(static_cast<uint64_t>(durationMs) * sampleRate / 1000);
+}
+
+// 音符间 1ms 静音
+inline uint32_t noteGap(uint32_t sampleRate)
+{
+    return sampleRate / 1000;
+}
+
+// Renders one note (without its trailing gap) into out[0..noteSamples). Phase restarts at
+// every note, so notes depend on nothing but themselves.
+template <typename N>
+static void renderNote(const N& n, float* out, uint32_t samples, uint32_t sampleRate,
+                       Waveform waveform, const Envelope& envelope)
+{
+    constexpr double baseFreq = 440.0; // A4
+    constexpr float amplitude = 0.2f;
+    osc::renderWave(waveform, out, samples, baseFreq * n.ratio, sampleRate);
+    env::apply(env::plan(noteEnvelope(n, envelope), samples, sampleRate, amplitude), out);
+}
+
 template <typename Container>
-static void generatePCM(const Container& notes, std::vector<float>& pcm, uint32_t sampleRate = 48000)
+static void generatePCM(const Container& notes, std::vector<float>& pcm, uint32_t sampleRate = 48000,
+                        Waveform waveform = Waveform::Sine, const Envelope& envelope = {})
 {
     pcm.clear();
-    constexpr double baseFreq = 440.0; // A4
-    const uint32_t fadeSamples = sampleRate / 200; // ~5ms 淡入淡出
 
     for (const auto& n : notes)
     {
-        constexpr double twoPi = 6.283185307179586;
-        const double freq = baseFreq * n.ratio;
-        const auto samples = static_cast<uint32_t>(static_cast<uint64_t>(n.duration_ms) * sampleRate / 1000);
-        double phase = 0.0;
-        const double phaseInc = twoPi * freq / sampleRate;
+        const uint32_t samples = noteSamples(n.duration_ms, sampleRate);
 
         size_t startIndex = pcm.size();
         pcm.resize(startIndex + samples);
+        renderNote(n, pcm.data() + startIndex, samples, sampleRate, waveform, envelope);
 
-        for (uint32_t i = 0; i < samples; ++i)
-        {
-            constexpr float amplitude = 0.2f;
-            float env = 1.0f;
-            if (i < fadeSamples)
-            {
-                env = static_cast<float>(i) / static_cast<float>(fadeSamples);
-            }
-            else if (i > samples - fadeSamples && samples > fadeSamples)
-            {
-                uint32_t tail = samples - i;
-                env = static_cast<float>(tail) / static_cast<float>(fadeSamples);
-            }
-            pcm[startIndex + i] = amplitude * env * static_cast<float>(std::sin(phase));
-            phase += phaseInc;
-            if (phase > twoPi) phase -= twoPi;
-        }
-
-        // 音符间 1ms 静音
-        const uint32_t gap = sampleRate / 1000;
-        pcm.resize(pcm.size() + gap, 0.0f);
+        pcm.resize(pcm.size() + noteGap(sampleRate), 0.0f);
     }
 }
 
+/**
+ * Opens the device in its native sample format, channel count and (when sampleRate is 0)
+ * sample rate, and renders for exactly that: phase increments use the real rate and the
+ * callback writes dithered integer / fanned-out frames itself, so miniaudio has no
+ * conversion or resampling left to do.
+ */
 template <typename Container>
-static int playMelody(const Container& notes, uint32_t sampleRate = 48000)
+static int playMelody(const Container& notes, uint32_t sampleRate = 0, Waveform waveform = Waveform::Sine,
+                      const Envelope& envelope = {})
 {
-    std::vector<float> pcm;
-    generatePCM(notes, pcm, sampleRate);
-
     ma_device_config config = ma_device_config_init(ma_device_type_playback);
-    config.playback.format = ma_format_f32;
-    config.playback.channels = 1;
+    config.playback.format = ma_format_unknown; // 使用设备原生格式
+    config.playback.channels = 0;
     config.sampleRate = sampleRate;
+    config.noPreSilencedOutputBuffer = MA_TRUE; // 回调总会写满整个缓冲
 
     struct PlaybackState
     {
         const float* data = nullptr;
         size_t total = 0;
-        size_t cursor = 0;
-    } state{pcm.data(), pcm.size(), 0};
+        std::atomic<size_t> cursor{0};
+        ma_format format = ma_format_f32;
+        uint32_t channels = 1;
+        Dither dither;
+    } state;
 
     config.dataCallback = [](ma_device* device, void* out, const void*, ma_uint32 frameCount)
     {
         auto* st = static_cast<PlaybackState*>(device->pUserData);
-        auto* dst = static_cast<float*>(out);
-        const auto samplesToWrite = static_cast<size_t>(frameCount); // 单声道
-        const size_t samplesLeft = st->total - st->cursor;
-        size_t n = samplesToWrite < samplesLeft ? samplesToWrite : samplesLeft;
-        if (n > 0)
-        {
-            std::memcpy(dst, st->data + st->cursor, n * sizeof(float));
-            st->cursor += n;
-        }
-        if (n < samplesToWrite)
+        const size_t cursor = st->cursor.load(std::memory_order_relaxed);
+        const size_t framesLeft = st->total - cursor;
+        const auto n = static_cast<uint32_t>(frameCount < framesLeft ? frameCount : framesLeft);
+        convert::writeFrames(st->data + cursor, out, n, st->format, st->channels, st->dither);
+        if (n < frameCount)
         {
-            std::memset(dst + n, 0, (samplesToWrite - n) * sizeof(float));
+            const size_t offset = static_cast<size_t>(n) * st->channels * ma_get_bytes_per_sample(st->format);
+            convert::writeSilence(static_cast<uint8_t*>(out) + offset, frameCount - n, st->format, st->channels);
         }
+        st->cursor.store(cursor + n, std::memory_order_release);
     };
     config.pUserData = &state;
 
@@ -100,6 +125,15 @@ static int playMelody(const Container& notes, uint32_t sampleRate = 48000)
         std::cerr << "音频设备初始化失败\n";
         return 1;
     }
+
+    // 设备打开后才知道原生参数，按实际采样率渲染
+    std::vector<float> pcm;
+    generatePCM(notes, pcm, device.sampleRate, waveform, envelope);
+    state.data = pcm.data();
+    state.total = pcm.size();
+    state.format = device.playback.format;
+    state.channels = device.playback.channels;
+
     if (ma_device_start(&device) != MA_SUCCESS)
     {
         std::cerr << "音频设备启动失败\n";
@@ -107,8 +141,9 @@ static int playMelody(const Container& notes, uint32_t sampleRate = 48000)
         return 1;
     }
 
-    while (state.cursor < state.total)
+    while (state.cursor.load(std::memory_order_acquire) < state.total)
     {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
     }
 
     ma_device_uninit(&device);
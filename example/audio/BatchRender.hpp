@@ -0,0 +1,96 @@
+#ifndef EMS_BATCH_RENDER_HPP
+#define EMS_BATCH_RENDER_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "ems_parser.hpp"
+#include "ThreadPool.hpp"
+#include "WavWriter.hpp"
+
+struct BatchJob
+{
+    std::string outputPath;
+    std::vector<ems::Note> notes;
+};
+
+struct BatchStats
+{
+    size_t files = 0;
+    size_t failed = 0;
+    uint64_t samples = 0;
+    double wallSeconds = 0.0;
+    std::vector<double> latencyMs; ///< Render + write time of each job, in job order.
+
+    [[nodiscard]] double samplesPerSecond() const { return wallSeconds > 0.0 ? samples / wallSeconds : 0.0; }
+
+    // Latency at quantile q in [0, 1].
+    [[nodiscard]] double latencyQuantile(double q) const
+    {
+        if (latencyMs.empty()) return 0.0;
+        std::vector<double> sorted = latencyMs;
+        std::sort(sorted.begin(), sorted.end());
+        return sorted[static_cast<size_t>(q * static_cast<double>(sorted.size() - 1) + 0.5)];
+    }
+};
+
+/**
+ * @brief Per-worker scratch state, reused for every job that worker runs.
+ * After the first few scores neither the PCM buffer nor the WAV staging buffer
+ * grow any more, so steady-state rendering does no allocation.
+ */
+struct RenderArena
+{
+    std::vector<float> pcm;
+    WavWriter writer;
+};
+
+/**
+ * @brief Renders every job to a WAV file, one task per score on a work-stealing pool.
+ * Blocks until all jobs are done; failures are counted, not thrown.
+ */
+static BatchStats renderBatch(const std::vector<BatchJob>& jobs, WorkStealingPool& pool,
+                              uint32_t sampleRate = 48000, SampleFormat format = SampleFormat::S16,
+                              Waveform waveform = Waveform::Sine, const Envelope& envelope = {})
+{
+    using Clock = std::chrono::steady_clock;
+
+    BatchStats stats;
+    stats.files = jobs.size();
+    stats.latencyMs.assign(jobs.size(), 0.0);
+
+    std::vector<RenderArena> arenas(pool.size());
+    std::vector<uint64_t> samples(jobs.size(), 0);
+    std::vector<uint8_t> failed(jobs.size(), 0);
+
+    const auto start = Clock::now();
+    pool.parallelFor(jobs.size(), jobs.size(), [&](const size_t begin, const size_t end)
+    {
+        RenderArena& arena = arenas[pool.currentWorker()];
+        for (size_t i = begin; i < end; ++i)
+        {
+            const auto t0 = Clock::now();
+            generatePCM(jobs[i].notes, arena.pcm, sampleRate, waveform, envelope);
+
+            bool ok = arena.writer.open(jobs[i].outputPath.c_str(), sampleRate, 1, format);
+            ok = ok && arena.writer.write(arena.pcm.data(), arena.pcm.size());
+            ok = arena.writer.close() && ok;
+
+            failed[i] = !ok;
+            samples[i] = arena.pcm.size();
+            stats.latencyMs[i] = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+        }
+    });
+    stats.wallSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    for (size_t i = 0; i < jobs.size(); ++i)
+    {
+        stats.samples += samples[i];
+        stats.failed += failed[i];
+    }
+    return stats;
+}
+
+#endif //EMS_BATCH_RENDER_HPP
@@ -0,0 +1,144 @@
+#ifndef EMS_CHORD_RENDER_HPP
+#define EMS_CHORD_RENDER_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "ems_parser.hpp"
+#include "Audio.hpp"
+
+namespace poly
+{
+    // Voice slots padded to a whole SSE/NEON register.
+    constexpr size_t lanesFor(const size_t voices)
+    {
+        return (voices + 3) / 4 * 4;
+    }
+
+    /**
+     * @brief Structure-of-arrays sine bank: one rotating phasor per lane.
+     *
+     * Each sample is a complex multiply per lane (four multiplies, two adds) with no
+     * transcendental call, so the lanes map directly onto SIMD registers. Silent
+     * slots rotate by 0 and contribute exactly 0, so no lane is ever skipped.
+     */
+    template <size_t Lanes>
+    struct PhasorBank
+    {
+        static constexpr uint32_t block = 256; ///< Most samples one render() call may produce.
+
+        alignas(16) float re[Lanes];
+        alignas(16) float im[Lanes];
+        alignas(16) float cr[Lanes];
+        alignas(16) float ci[Lanes];
+
+        void reset(const float* freqs, const uint32_t sampleRate)
+        {
+            constexpr double twoPi = 6.283185307179586;
+            for (size_t v = 0; v < Lanes; ++v)
+            {
+                const double w = twoPi * freqs[v] / sampleRate;
+                re[v] = 1.0f;
+                im[v] = 0.0f;
+                cr[v] = static_cast<float>(std::cos(w));
+                ci[v] = static_cast<float>(std::sin(w));
+            }
+        }
+
+        /**
+         * @brief Sums all lanes into out[0..count), count <= block.
+         * The rotation writes every lane's samples to its own row; the rows are then
+         * added into `out` one lane at a time. Both loops are element-wise (across
+         * lanes, then across samples) with no horizontal reduction, and each sample is
+         * still summed in lane order.
+         */
+        void render(float* out, const uint32_t count)
+        {
+            alignas(16) float taps[Lanes][block]; // 局部数组，编译器可确定与 out 不重叠
+
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                for (size_t v = 0; v < Lanes; ++v)
+                {
+                    taps[v][i] = im[v];
+                    const float r = re[v] * cr[v] - im[v] * ci[v];
+                    const float m = re[v] * ci[v] + im[v] * cr[v];
+                    re[v] = r;
+                    im[v] = m;
+                }
+            }
+
+            std::copy_n(taps[0], count, out);
+            for (size_t v = 1; v < Lanes; ++v)
+            {
+                for (uint32_t i = 0; i < count; ++i) out[i] += taps[v][i];
+            }
+        }
+
+        // Pulls every phasor back onto the unit circle (one Newton step), once per block.
+        void normalize()
+        {
+            for (size_t v = 0; v < Lanes; ++v)
+            {
+                const float g = 1.5f - 0.5f * (re[v] * re[v] + im[v] * im[v]);
+                re[v] *= g;
+                im[v] *= g;
+            }
+        }
+    };
+} // namespace poly
+
+// Renders one chord event (without its trailing gap); the output level does not depend on the chord size.
+template <size_t V>
+static void renderChord(const ems::Chord<V>& chord, float* out, uint32_t samples, uint32_t sampleRate,
+                        const Envelope& envelope)
+{
+    constexpr size_t Lanes = poly::lanesFor(V);
+    constexpr double baseFreq = 440.0; // A4
+    constexpr float amplitude = 0.2f;
+
+    float freqs[Lanes]{};
+    size_t active = 0;
+    for (size_t v = 0; v < V; ++v)
+    {
+        freqs[v] = static_cast<float>(baseFreq * chord.ratios[v]);
+        active += chord.ratios[v] > 0.0f;
+    }
+
+    poly::PhasorBank<Lanes> bank;
+    constexpr uint32_t block = poly::PhasorBank<Lanes>::block;
+    bank.reset(freqs, sampleRate);
+    for (uint32_t done = 0; done < samples; done += block)
+    {
+        bank.render(out + done, std::min(block, samples - done));
+        bank.normalize();
+    }
+
+    const float gain = amplitude / static_cast<float>(std::max<size_t>(active, 1));
+    env::apply(env::plan(envelope, samples, sampleRate, gain), out);
+}
+
+/**
+ * @brief generatePCM() for `_ems_poly` scores.
+ * Every chord is rendered in one pass over its slice, whatever its size.
+ */
+template <typename Container>
+static void generatePCMPoly(const Container& chords, std::vector<float>& pcm, uint32_t sampleRate = 48000,
+                            const Envelope& envelope = {})
+{
+    pcm.clear();
+
+    for (const auto& c : chords)
+    {
+        const uint32_t samples = noteSamples(c.duration_ms, sampleRate);
+
+        size_t startIndex = pcm.size();
+        pcm.resize(startIndex + samples);
+        renderChord(c, pcm.data() + startIndex, samples, sampleRate, envelope);
+
+        pcm.resize(pcm.size() + noteGap(sampleRate), 0.0f);
+    }
+}
+
+#endif //EMS_CHORD_RENDER_HPP
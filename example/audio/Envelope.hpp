@@ -0,0 +1,162 @@
+#ifndef EMS_ENVELOPE_HPP
+#define EMS_ENVELOPE_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+#include "ems_parser.hpp"
+
+/**
+ * @brief ADSR amplitude envelope, in milliseconds and linear levels.
+ *
+ * The note's sounding length is `gate * duration`; the release is taken from the
+ * end of that window, and anything after it is silence. The defaults reproduce
+ * the historical ~5ms fade in / fade out.
+ */
+struct Envelope
+{
+    float attackMs = 5.0f;
+    float peak = 1.0f; ///< Level reached at the end of the attack; above 1 for accents.
+    float decayMs = 0.0f;
+    float sustain = 1.0f; ///< Level held after the decay, 0..1.
+    float releaseMs = 5.0f;
+    float gate = 1.0f; ///< Fraction of the note that sounds, 0..1.
+};
+
+/**
+ * @brief Per-note articulation, written in the score as `~` `'` `=` `>` (see ems_parser.hpp).
+ * Notes parsed with `_ems_art` carry it, and generatePCM() plays each one with the
+ * matching variant of the score envelope.
+ */
+using Articulation = ems::Articulation;
+
+constexpr Envelope articulate(const Articulation articulation, Envelope base)
+{
+    switch (articulation)
+    {
+    case Articulation::Legato:
+        base.attackMs = 1.0f;
+        base.releaseMs = 1.0f;
+        break;
+    case Articulation::Staccato:
+        base.gate = 0.5f;
+        base.releaseMs = std::min(base.releaseMs, 3.0f);
+        break;
+    case Articulation::Tenuto:
+        base.decayMs = 0.0f;
+        base.sustain = 1.0f;
+        break;
+    case Articulation::Accent:
+        // 起音更响，再回落到原来的持续电平
+        base.peak = base.peak * 1.5f;
+        base.decayMs = std::max(base.decayMs, 60.0f);
+        break;
+    default:
+        break;
+    }
+    return base;
+}
+
+namespace env
+{
+    /**
+     * @brief One linear piece of the envelope: `level` starts at `start` and moves by `step` per sample.
+     */
+    struct Segment
+    {
+        uint32_t length;
+        float start;
+        float step;
+    };
+
+    // Attack, decay, sustain, release, trailing silence.
+    using Plan = std::array<Segment, 5>;
+
+    /**
+     * @brief Splits a note of `samples` frames into its envelope segments.
+     * All clamping for short notes happens here, once per note, so apply() has
+     * no per-sample decisions left to make. `gain` is folded into the levels.
+     */
+    inline Plan plan(const Envelope& e, const uint32_t samples, const uint32_t sampleRate, const float gain)
+    {
+        const auto toSamples = [sampleRate](const float ms)
+        {
+            return static_cast<uint32_t>(std::max(ms, 0.0f) * static_cast<float>(sampleRate) / 1000.0f);
+        };
+
+        const auto gated = static_cast<uint32_t>(static_cast<float>(samples) * std::clamp(e.gate, 0.0f, 1.0f));
+        const uint32_t attackFull = toSamples(e.attackMs);
+        const uint32_t decayFull = toSamples(e.decayMs);
+        const float top = std::max(e.peak, 0.0f);
+        const float sustain = std::clamp(e.sustain, 0.0f, 1.0f);
+
+        // 先保证释放段，短音符依次截断 attack 与 decay
+        const uint32_t r = std::min(toSamples(e.releaseMs), gated);
+        const uint32_t a = std::min(attackFull, gated - r);
+        const uint32_t d = std::min(decayFull, gated - r - a);
+        const uint32_t s = gated - r - a - d;
+
+        const float attackStep = attackFull > 0 ? top / static_cast<float>(attackFull) : 0.0f;
+        const float peak = attackFull > 0 ? static_cast<float>(a) * attackStep : top;
+        const float decayStep = decayFull > 0 ? (sustain - top) / static_cast<float>(decayFull) : 0.0f;
+        const float held = decayFull > 0 ? peak + decayStep * static_cast<float>(d) : (a < attackFull ? peak : sustain);
+        const float releaseStep = r > 0 ? -held / static_cast<float>(r) : 0.0f;
+
+        return Plan{{
+            {a, 0.0f, attackStep * gain},
+            {d, peak * gain, decayStep * gain},
+            {s, held * gain, 0.0f},
+            {r, held * gain, releaseStep * gain},
+            {samples - gated, 0.0f, 0.0f},
+        }};
+    }
+
+    /**
+     * @brief Multiplies `out` by the planned envelope in place.
+     * Each segment is one incremental multiply-add loop with no branches inside.
+     */
+    inline void apply(const Plan& plan, float* out)
+    {
+        for (const auto& [length, start, step] : plan)
+        {
+            float level = start;
+            for (uint32_t i = 0; i < length; ++i)
+            {
+                out[i] *= level;
+                level += step;
+            }
+            out += length;
+        }
+    }
+
+    /**
+     * @brief Applies the part of `plan` covering note samples [first, first + count).
+     * Used by streaming voices that render a note across several callbacks; the level
+     * at the start of each run is computed directly, then stepped like apply().
+     */
+    inline void applyRange(const Plan& plan, float* out, uint32_t first, uint32_t count)
+    {
+        uint32_t segStart = 0;
+        for (const auto& [length, start, step] : plan)
+        {
+            const uint32_t segEnd = segStart + length;
+            if (count > 0 && first < segEnd)
+            {
+                const uint32_t n = std::min(count, segEnd - first);
+                float level = start + step * static_cast<float>(first - segStart);
+                for (uint32_t i = 0; i < n; ++i)
+                {
+                    out[i] *= level;
+                    level += step;
+                }
+                out += n;
+                first += n;
+                count -= n;
+            }
+            segStart = segEnd;
+        }
+    }
+} // namespace env
+
+#endif //EMS_ENVELOPE_HPP
@@ -0,0 +1,98 @@
+#ifndef EMS_LIVE_CONTROL_HPP
+#define EMS_LIVE_CONTROL_HPP
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+
+#include "Oscillator.hpp"
+
+/**
+ * @brief Playback parameters that control threads may change while audio is running.
+ *
+ * Each parameter is an independent atomic, so setters never block and never wait for
+ * the audio thread; the callback takes one snapshot() per block and ramps towards it
+ * (see Ramp), which makes every change audible within one device period, click-free.
+ */
+class LiveControl
+{
+public:
+    struct Snapshot
+    {
+        float pitch; ///< Frequency multiplier derived from the transpose.
+        float volume;
+        bool overrideWaveform;
+        Waveform waveform;
+    };
+
+    // Semitones, fractional values allowed (detune).
+    void setTranspose(float semitones) { transpose.store(semitones, std::memory_order_relaxed); }
+    void setVolume(float gain) { volume.store(gain, std::memory_order_relaxed); }
+
+    // Replaces the waveform of whatever is playing; clearWaveform() returns to the melody's own.
+    void setWaveform(Waveform shape) { waveform.store(static_cast<uint8_t>(shape), std::memory_order_relaxed); }
+    void clearWaveform() { waveform.store(kOwnWaveform, std::memory_order_relaxed); }
+
+    [[nodiscard]] Snapshot snapshot() const
+    {
+        const uint8_t shape = waveform.load(std::memory_order_relaxed);
+        return Snapshot{
+            std::exp2(transpose.load(std::memory_order_relaxed) / 12.0f),
+            volume.load(std::memory_order_relaxed),
+            shape != kOwnWaveform,
+            static_cast<Waveform>(shape == kOwnWaveform ? 0 : shape),
+        };
+    }
+
+private:
+    static constexpr uint8_t kOwnWaveform = 0xFF;
+
+    std::atomic<float> transpose{0.0f};
+    std::atomic<float> volume{1.0f};
+    std::atomic<uint8_t> waveform{kOwnWaveform};
+
+    static_assert(std::atomic<float>::is_always_lock_free, "LiveControl must be lock-free");
+};
+
+/**
+ * @brief Linear per-sample ramp towards the latest target, reached after `frames` samples.
+ */
+struct Ramp
+{
+    float value = 1.0f;
+    float target = 1.0f;
+    float step = 0.0f;
+    uint32_t left = 0;
+
+    void retarget(float to, uint32_t frames)
+    {
+        if (to == target) return;
+        target = to;
+        left = frames;
+        step = frames > 0 ? (to - value) / static_cast<float>(frames) : 0.0f;
+        if (frames == 0) value = to;
+    }
+
+    float next()
+    {
+        if (left == 0) return value;
+        value = --left == 0 ? target : value + step;
+        return value;
+    }
+
+    void skip(uint32_t frames)
+    {
+        if (frames >= left)
+        {
+            value = target;
+            left = 0;
+        }
+        else
+        {
+            value += step * static_cast<float>(frames);
+            left -= frames;
+        }
+    }
+};
+
+#endif //EMS_LIVE_CONTROL_HPP
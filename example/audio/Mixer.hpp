@@ -0,0 +1,235 @@
+#ifndef EMS_MIXER_HPP
+#define EMS_MIXER_HPP
+
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+
+#include "MpscQueue.hpp"
+#include "SampleConvert.hpp"
+#include "Voice.hpp"
+
+/**
+ * @brief Persistent sound-effect mixer with a fixed voice pool.
+ *
+ * play()/stop() may be called from any thread: they only push a command into a
+ * lock-free MPSC queue. The audio callback drains the queue at the start of every
+ * period, so a trigger is heard at most one device period later. When all voices
+ * are busy the lowest-priority (then oldest) voice is stolen, provided it is not
+ * more important than the new sound. The mix goes through a soft limiter so many
+ * simultaneous effects saturate smoothly instead of clipping.
+ *
+ * Melodies are referenced, not copied: pass arrays that outlive playback.
+ */
+template <size_t MaxVoices = 32, size_t QueueSize = 256>
+class SfxMixer
+{
+public:
+    using VoiceId = uint32_t; ///< 0 is never a valid id.
+
+    SfxMixer() = default;
+    SfxMixer(const SfxMixer&) = delete;
+    SfxMixer& operator=(const SfxMixer&) = delete;
+    ~SfxMixer() { close(); }
+
+    // sampleRate = 0 uses the device's native rate.
+    int open(uint32_t sampleRate = 0)
+    {
+        ma_device_config config = ma_device_config_init(ma_device_type_playback);
+        config.playback.format = ma_format_unknown; // 使用设备原生格式
+        config.playback.channels = 0;
+        config.sampleRate = sampleRate;
+        config.performanceProfile = ma_performance_profile_low_latency;
+        config.noPreSilencedOutputBuffer = MA_TRUE;
+        config.dataCallback = [](ma_device* device, void* out, const void*, ma_uint32 frameCount)
+        {
+            auto* self = static_cast<SfxMixer*>(device->pUserData);
+            const uint32_t frameBytes = self->channels * ma_get_bytes_per_sample(self->format);
+            for (uint32_t done = 0; done < frameCount;)
+            {
+                const uint32_t n = std::min<uint32_t>(frameCount - done, kMaxFrames);
+                self->render(self->scratch.data(), n);
+                convert::writeFrames(self->scratch.data(), static_cast<uint8_t*>(out) + done * frameBytes, n,
+                                     self->format, self->channels, self->dither);
+                done += n;
+            }
+        };
+        config.pUserData = this;
+
+        if (ma_device_init(nullptr, &config, &device) != MA_SUCCESS)
+        {
+            std::cerr << "音频设备初始化失败\n";
+            return 1;
+        }
+        rate = device.sampleRate;
+        format = device.playback.format;
+        channels = device.playback.channels;
+
+        if (ma_device_start(&device) != MA_SUCCESS)
+        {
+            std::cerr << "音频设备启动失败\n";
+            ma_device_uninit(&device);
+            return 1;
+        }
+        opened = true;
+        return 0;
+    }
+
+    void close()
+    {
+        if (opened)
+        {
+            ma_device_uninit(&device);
+            opened = false;
+        }
+    }
+
+    [[nodiscard]] uint32_t sampleRate() const { return rate; }
+
+    /**
+     * @brief Triggers a melody. Thread-safe, wait-free unless producers collide.
+     * @return The voice id, or 0 if the command queue was full.
+     */
+    VoiceId play(const ems::Note* notes, size_t count, uint8_t priority = 0, float gain = 1.0f,
+                 Waveform waveform = Waveform::Sine)
+    {
+        VoiceId id = nextId.fetch_add(1, std::memory_order_relaxed) + 1;
+        if (id == 0) id = nextId.fetch_add(1, std::memory_order_relaxed) + 1; // 回绕时跳过 0
+        return commands.push(Command{Command::Play, id, notes, count, priority, gain, waveform}) ? id : 0;
+    }
+
+    template <typename Container>
+    VoiceId play(const Container& notes, uint8_t priority = 0, float gain = 1.0f, Waveform waveform = Waveform::Sine)
+    {
+        return play(std::data(notes), std::size(notes), priority, gain, waveform);
+    }
+
+    bool stop(VoiceId id) { return commands.push(Command{Command::Stop, id}); }
+    bool stopAll() { return commands.push(Command{Command::StopAll, 0}); }
+
+    // Number of voices sounding at the end of the last rendered block (approximate outside the callback).
+    [[nodiscard]] size_t activeVoices() const { return active.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Mixes `frames` mono frames into `out` (overwriting it).
+     * Called from the audio callback; public so the mixer can also be driven offline.
+     */
+    void render(float* out, uint32_t frames)
+    {
+        Command cmd;
+        while (commands.pop(cmd)) apply(cmd);
+
+        std::memset(out, 0, frames * sizeof(float));
+        size_t sounding = 0;
+        for (auto& s : slots)
+        {
+            if (!s.voice.active()) continue;
+            s.voice.mix(out, frames, s.gain);
+            sounding += s.voice.active();
+        }
+        softLimit(out, frames);
+
+        clock += frames;
+        active.store(sounding, std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr uint32_t kMaxFrames = 4096;
+
+    struct Command
+    {
+        enum Type : uint8_t { Play, Stop, StopAll };
+
+        Type type = Play;
+        VoiceId id = 0;
+        const ems::Note* notes = nullptr;
+        size_t count = 0;
+        uint8_t priority = 0;
+        float gain = 1.0f;
+        Waveform waveform = Waveform::Sine;
+    };
+
+    struct Slot
+    {
+        MelodyVoice voice;
+        VoiceId id = 0;
+        uint8_t priority = 0;
+        uint64_t startedAt = 0;
+        float gain = 1.0f;
+    };
+
+    void apply(const Command& cmd)
+    {
+        switch (cmd.type)
+        {
+        case Command::Play:
+        {
+            Slot* target = nullptr;
+            for (auto& s : slots)
+            {
+                if (!s.voice.active())
+                {
+                    target = &s;
+                    break;
+                }
+                // 抢占：优先级最低者，其次最早开始者
+                if (target == nullptr || s.priority < target->priority ||
+                    (s.priority == target->priority && s.startedAt < target->startedAt))
+                {
+                    target = &s;
+                }
+            }
+            if (target->voice.active() && target->priority > cmd.priority) return; // 丢弃
+
+            target->voice.start(cmd.notes, cmd.count, rate, cmd.waveform);
+            target->id = cmd.id;
+            target->priority = cmd.priority;
+            target->startedAt = clock;
+            target->gain = cmd.gain;
+            break;
+        }
+        case Command::Stop:
+            for (auto& s : slots)
+            {
+                if (s.id == cmd.id) s.voice.stop();
+            }
+            break;
+        case Command::StopAll:
+            for (auto& s : slots) s.voice.stop();
+            break;
+        }
+    }
+
+    // x·(27 + x²) / (27 + 9x²) on x clamped to ±3: unity slope at 0, reaches ±1 smoothly at ±3.
+    // The clamp uses fabs instead of compares, so the loop vectorises.
+    static void softLimit(float* buf, uint32_t n)
+    {
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            const float x = buf[i];
+            const float c = 0.5f * (std::fabs(x + 3.0f) - std::fabs(x - 3.0f));
+            const float c2 = c * c;
+            buf[i] = c * (27.0f + c2) / (27.0f + 9.0f * c2);
+        }
+    }
+
+    ma_device device{};
+    bool opened = false;
+    uint32_t rate = 48000;
+    ma_format format = ma_format_f32;
+    uint32_t channels = 1;
+    Dither dither;
+
+    MpscQueue<Command, QueueSize> commands;
+    std::atomic<VoiceId> nextId{0};
+    std::array<Slot, MaxVoices> slots{};
+    std::array<float, kMaxFrames> scratch{};
+    uint64_t clock = 0;
+    std::atomic<size_t> active{0};
+};
+
+#endif //EMS_MIXER_HPP
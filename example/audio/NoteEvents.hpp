@@ -0,0 +1,85 @@
+#ifndef EMS_NOTE_EVENTS_HPP
+#define EMS_NOTE_EVENTS_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "Voice.hpp"
+
+/**
+ * @brief Note boundary published by the audio callback.
+ * `frame` counts output frames since the device started, so it is exact to the sample.
+ */
+struct NoteEvent
+{
+    uint64_t frame = 0;
+    uint32_t melody = 0; ///< Ordinal of the enqueue() call that queued the melody.
+    uint32_t note = 0; ///< Index of the note inside its melody.
+    float ratio = 0.0f; ///< Frequency ratio of the note, 0.0 = rest.
+    NoteEdge edge = NoteEdge::On;
+};
+
+/**
+ * @brief Maps output frame numbers to the steady_clock time they reach the speaker.
+ *
+ * Every callback anchors the first frame it renders to the current time; that frame
+ * is heard one device buffer (`latencyFrames`) later. Readers on other threads get a
+ * consistent anchor through a seqlock, so neither side ever blocks.
+ */
+class PlaybackClock
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    // Before the device starts.
+    void configure(uint32_t sampleRate, uint32_t latencyFrames)
+    {
+        rate = sampleRate;
+        latency = latencyFrames;
+    }
+
+    // Audio thread, at the start of each callback.
+    void anchor(uint64_t frame, clock::time_point now)
+    {
+        const uint32_t s = seq.load(std::memory_order_relaxed);
+        seq.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        anchorFrame.store(frame, std::memory_order_relaxed);
+        anchorTime.store(now.time_since_epoch().count(), std::memory_order_relaxed);
+        seq.store(s + 2, std::memory_order_release);
+    }
+
+    // Any thread. Returns a default time_point until the first callback has run.
+    [[nodiscard]] clock::time_point toSteady(uint64_t frame) const
+    {
+        uint64_t f;
+        clock::rep t;
+        uint32_t s;
+        do
+        {
+            s = seq.load(std::memory_order_acquire);
+            f = anchorFrame.load(std::memory_order_relaxed);
+            t = anchorTime.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+        while ((s & 1) != 0 || s != seq.load(std::memory_order_relaxed));
+
+        if (s == 0) return {};
+        const auto offset = static_cast<int64_t>(frame - f) + latency;
+        const auto delay = std::chrono::duration_cast<clock::duration>(
+            std::chrono::duration<double>(static_cast<double>(offset) / rate));
+        return clock::time_point(clock::duration(t)) + delay;
+    }
+
+    [[nodiscard]] uint32_t latencyFrames() const { return latency; }
+
+private:
+    uint32_t rate = 48000;
+    uint32_t latency = 0;
+    std::atomic<uint32_t> seq{0};
+    std::atomic<uint64_t> anchorFrame{0};
+    std::atomic<clock::rep> anchorTime{0};
+};
+
+#endif //EMS_NOTE_EVENTS_HPP
@@ -0,0 +1,133 @@
+#ifndef EMS_OSCILLATOR_HPP
+#define EMS_OSCILLATOR_HPP
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * @brief Oscillator shapes supported by generatePCM().
+ *
+ * Square, Saw and Triangle are band-limited with PolyBLEP / PolyBLAMP residuals:
+ * the naive waveform is corrected only in the one-sample neighbourhood of each
+ * discontinuity, which removes most audible aliasing at a fraction of the cost
+ * of oversampling or additive synthesis.
+ */
+enum class Waveform : uint8_t
+{
+    Sine,
+    Square,
+    Saw,
+    Triangle,
+};
+
+namespace osc
+{
+    // max(v, 0) without a compare, so that the loops below if-convert even under -ftrapping-math.
+    inline float ramp(const float v)
+    {
+        return 0.5f * (v + std::fabs(v));
+    }
+
+    // Two-sample polynomial band-limited step residual; t is the normalised phase in [0, 1).
+    // x / y are the distances into the one-sample windows after / before the discontinuity,
+    // clamped to zero elsewhere, so the residual is pure arithmetic and the kernels vectorise.
+    inline float polyBlep(const float t, const float dt)
+    {
+        const float x = ramp(1.0f - t / dt);
+        const float y = ramp(1.0f - (1.0f - t) / dt);
+        return y * y - x * x;
+    }
+
+    // Integrated polyBlep, used to round off slope discontinuities (triangle corners).
+    inline float polyBlamp(const float t, const float dt)
+    {
+        const float x = ramp(1.0f - t / dt);
+        const float y = ramp(1.0f - (1.0f - t) / dt);
+        return (x * x * x + y * y * y) * (1.0f / 3.0f);
+    }
+
+    // Fractional part of a non-negative phase below 2^31. Truncating through int32
+    // (rather than std::floor) keeps the loops vectorisable without -fno-trapping-math.
+    inline float wrap(const double x)
+    {
+        return static_cast<float>(x - static_cast<int32_t>(x));
+    }
+
+    // Phase in cycles after `count` samples starting from `phase0`.
+    inline double advancePhase(const double phase0, const uint32_t count, const double freq, const uint32_t sampleRate)
+    {
+        const double x = phase0 + freq * count / sampleRate;
+        return x - std::floor(x);
+    }
+
+    /**
+     * @brief Fills `out[0..count)` with one note's raw waveform in [-1, 1].
+     * @param freq Oscillator frequency in Hz; <= 0 renders silence (rest).
+     *
+     * @param phase0 Starting phase in cycles, [0, 1). generatePCM() starts every note at 0;
+     *        streaming voices pass the phase where their previous block ended.
+     *
+     * Each non-sine sample is computed from its index only (no loop-carried state).
+     */
+    inline void renderWave(const Waveform waveform, float* out, const uint32_t count,
+                           const double freq, const uint32_t sampleRate, const double phase0 = 0.0)
+    {
+        if (freq <= 0.0)
+        {
+            std::memset(out, 0, count * sizeof(float));
+            return;
+        }
+
+        if (waveform == Waveform::Sine)
+        {
+            constexpr double twoPi = 6.283185307179586;
+            const double phaseInc = twoPi * freq / sampleRate;
+            double phase = twoPi * phase0;
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                out[i] = static_cast<float>(std::sin(phase));
+                phase += phaseInc;
+                if (phase > twoPi) phase -= twoPi;
+            }
+            return;
+        }
+
+        const double dtd = freq / sampleRate;
+        const auto dt = static_cast<float>(dtd);
+
+        switch (waveform)
+        {
+        case Waveform::Square:
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                const float t = wrap(phase0 + dtd * static_cast<int32_t>(i));
+                const float t2 = wrap(phase0 + dtd * static_cast<int32_t>(i) + 0.5);
+                const float naive = 1.0f - 2.0f * static_cast<float>(t >= 0.5f);
+                out[i] = naive + polyBlep(t, dt) - polyBlep(t2, dt);
+            }
+            break;
+        case Waveform::Saw:
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                const float t = wrap(phase0 + dtd * static_cast<int32_t>(i));
+                out[i] = 2.0f * t - 1.0f - polyBlep(t, dt);
+            }
+            break;
+        case Waveform::Triangle:
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                const float t = wrap(phase0 + dtd * static_cast<int32_t>(i));
+                const float t2 = wrap(phase0 + dtd * static_cast<int32_t>(i) + 0.5);
+                const float naive = 2.0f * std::fabs(2.0f * t - 1.0f) - 1.0f;
+                // 斜率在 t=0 处 +4→-4（波峰），在 t=0.5 处 -4→+4（波谷）
+                out[i] = naive + 4.0f * dt * (polyBlamp(t2, dt) - polyBlamp(t, dt));
+            }
+            break;
+        default:
+            break;
+        }
+    }
+} // namespace osc
+
+#endif //EMS_OSCILLATOR_HPP
@@ -0,0 +1,71 @@
+#ifndef EMS_PARALLEL_RENDER_HPP
+#define EMS_PARALLEL_RENDER_HPP
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+#include "Audio.hpp"
+#include "ThreadPool.hpp"
+
+/**
+ * @brief Start offset of every note in the PCM stream produced by generatePCM().
+ * offsets[i] is where note i begins; offsets[size] is the total length.
+ */
+template <typename Container>
+static void pcmLayout(const Container& notes, std::vector<size_t>& offsets, uint32_t sampleRate = 48000)
+{
+    offsets.clear();
+    offsets.reserve(std::size(notes) + 1);
+    size_t cursor = 0;
+    for (const auto& n : notes)
+    {
+        offsets.push_back(cursor);
+        cursor += noteSamples(n.duration_ms, sampleRate) + noteGap(sampleRate);
+    }
+    offsets.push_back(cursor);
+}
+
+/**
+ * @brief Multi-threaded generatePCM(), bit-identical to the sequential path.
+ *
+ * Note offsets come from a prefix sum of durations, and every note starts at phase
+ * zero, so each note range can be rendered straight into its own slice of the one
+ * preallocated buffer with nothing to stitch afterwards. Ranges are balanced by
+ * sample count rather than note count, and idle workers steal the leftovers.
+ *
+ * `notes` must be a random-access container (std::array, std::span, std::vector).
+ */
+template <typename Container>
+static void generatePCMParallel(const Container& notes, std::vector<float>& pcm, WorkStealingPool& pool,
+                                uint32_t sampleRate = 48000, Waveform waveform = Waveform::Sine,
+                                const Envelope& envelope = {})
+{
+    std::vector<size_t> offsets;
+    pcmLayout(notes, offsets, sampleRate);
+    const size_t total = offsets.back();
+    const size_t count = offsets.size() - 1;
+
+    pcm.assign(total, 0.0f); // 音符间隙保持为 0
+
+    // 按样本数均分，每个 worker 约 4 块，便于窃取平衡尾部
+    const size_t chunks = std::min(count, pool.size() * 4);
+    const auto firstNoteAt = [&](const size_t chunk)
+    {
+        const size_t sample = total * chunk / chunks;
+        return static_cast<size_t>(std::lower_bound(offsets.begin(), offsets.end() - 1, sample) - offsets.begin());
+    };
+
+    pool.parallelFor(chunks, chunks, [&](const size_t chunkBegin, const size_t chunkEnd)
+    {
+        const size_t last = chunkEnd == chunks ? count : firstNoteAt(chunkEnd);
+        for (size_t i = firstNoteAt(chunkBegin); i < last; ++i)
+        {
+            const auto& n = std::begin(notes)[i];
+            renderNote(n, pcm.data() + offsets[i], noteSamples(n.duration_ms, sampleRate), sampleRate, waveform,
+                       envelope);
+        }
+    });
+}
+
+#endif //EMS_PARALLEL_RENDER_HPP
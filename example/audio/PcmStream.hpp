@@ -0,0 +1,97 @@
+#ifndef EMS_PCM_STREAM_HPP
+#define EMS_PCM_STREAM_HPP
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <vector>
+
+#include "Audio.hpp"
+#include "ems_timeline.hpp"
+
+/**
+ * @brief Pull-based generatePCM(): hands out the same samples in caller-sized blocks.
+ *
+ * Only the note currently being played is materialised, so memory is bounded by the
+ * longest note instead of the whole song, and the scratch buffer's capacity is reused
+ * from note to note. The output is bit-identical to generatePCM().
+ * `notes` is referenced, not copied, and must outlive the stream.
+ *
+ * seek() resumes from any timestamp without rendering what comes before it. With an
+ * index in frames at the stream's rate, the next read() starts at exactly t * rate:
+ *   constexpr auto index = ems::time_index<48000>(melody);
+ *   stream.seek(ems::seek(index, 90 * 48000)); // 1:30
+ */
+template <typename Container>
+class PcmStream
+{
+public:
+    explicit PcmStream(const Container& notes, uint32_t sampleRate = 48000, Waveform waveform = Waveform::Sine,
+                       const Envelope& envelope = {})
+        : notes(notes), rate(sampleRate), waveform(waveform), envelope(envelope), it(std::begin(notes))
+    {
+    }
+
+    [[nodiscard]] bool done() const { return it == std::end(notes) && cursor == current.size(); }
+    [[nodiscard]] uint32_t sampleRate() const { return rate; }
+
+    // Writes up to `frames` mono samples to dst and returns how many were written (0 at the end).
+    size_t read(float* dst, size_t frames)
+    {
+        size_t written = 0;
+        while (written < frames)
+        {
+            if (cursor == current.size() && !advance()) break;
+
+            const size_t n = std::min(frames - written, current.size() - cursor);
+            std::memcpy(dst + written, current.data() + cursor, n * sizeof(float));
+            cursor += n;
+            written += n;
+        }
+        return written;
+    }
+
+    // Restarts at note `index`, `offsetFrames` into it (its gap included). Past the end, the stream is done.
+    void seek(const size_t index, const uint32_t offsetFrames = 0)
+    {
+        current.clear();
+        cursor = 0;
+        if (index >= static_cast<size_t>(std::size(notes)))
+        {
+            it = std::end(notes);
+            return;
+        }
+        it = std::next(std::begin(notes), static_cast<std::ptrdiff_t>(index));
+        advance();
+        cursor = std::min<size_t>(offsetFrames, current.size());
+    }
+
+    // `position` must come from a frame index at this stream's rate (ems::time_index<Rate>()).
+    void seek(const ems::SeekResult& position) { seek(position.index, position.offset); }
+
+private:
+    // Renders the next note plus its trailing gap into `current`.
+    bool advance()
+    {
+        if (it == std::end(notes)) return false;
+
+        const auto& n = *it++;
+        const uint32_t samples = noteSamples(n.duration_ms, rate);
+        current.resize(samples + noteGap(rate));
+        renderNote(n, current.data(), samples, rate, waveform, envelope);
+        std::fill(current.begin() + samples, current.end(), 0.0f);
+        cursor = 0;
+        return true;
+    }
+
+    const Container& notes;
+    uint32_t rate;
+    Waveform waveform;
+    Envelope envelope;
+
+    decltype(std::begin(std::declval<const Container&>())) it;
+    std::vector<float> current;
+    size_t cursor = 0;
+};
+
+#endif //EMS_PCM_STREAM_HPP
@@ -0,0 +1,252 @@
+#ifndef EMS_PLAYER_HPP
+#define EMS_PLAYER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+
+#include "LiveControl.hpp"
+#include "MpscQueue.hpp"
+#include "NoteEvents.hpp"
+#include "SampleConvert.hpp"
+#include "SpscQueue.hpp"
+#include "Voice.hpp"
+
+/**
+ * @brief Long-lived playback device with a melody queue.
+ *
+ * The device is opened once and keeps running, writing silence while idle, so
+ * starting a melody costs one queue push instead of a device init. Queued melodies
+ * play back to back with no gap beyond their own note gaps: when one ends inside a
+ * callback, the next starts on the following sample. The callback only pops from a
+ * lock-free queue and synthesises with MelodyVoice; it never allocates or locks.
+ *
+ *   Player<> player;
+ *   player.open();
+ *   player.enqueue(intro);
+ *   player.enqueue(loop);   // starts exactly when intro ends
+ *
+ * Melodies are referenced, not copied: pass arrays that outlive playback.
+ *
+ * controls() may be changed from any thread while playing (transpose, volume,
+ * waveform); the callback picks the new values up on its next block and ramps to
+ * them per sample, without re-rendering anything.
+ *
+ * Every note-on / note-off is published to events() with its exact output frame;
+ * one reader thread (UI, LEDs) pops them and schedules itself with
+ * clock().toSteady(event.frame), which already includes the device latency:
+ *
+ *   NoteEvent e;
+ *   while (player.events().pop(e)) lights.at(player.clock().toSteady(e.frame), e);
+ */
+template <size_t QueueSize = 64, size_t EventQueueSize = 1024>
+class Player
+{
+public:
+    Player() = default;
+    Player(const Player&) = delete;
+    Player& operator=(const Player&) = delete;
+    ~Player() { close(); }
+
+    // sampleRate = 0 uses the device's native rate.
+    int open(uint32_t sampleRate = 0)
+    {
+        ma_device_config config = ma_device_config_init(ma_device_type_playback);
+        config.playback.format = ma_format_unknown; // 使用设备原生格式
+        config.playback.channels = 0;
+        config.sampleRate = sampleRate;
+        config.performanceProfile = ma_performance_profile_low_latency;
+        config.noPreSilencedOutputBuffer = MA_TRUE;
+        config.dataCallback = [](ma_device* device, void* out, const void*, ma_uint32 frameCount)
+        {
+            auto* self = static_cast<Player*>(device->pUserData);
+            self->playback.anchor(self->rendered, PlaybackClock::clock::now());
+            const uint32_t frameBytes = self->channels * ma_get_bytes_per_sample(self->format);
+            for (uint32_t done = 0; done < frameCount;)
+            {
+                const uint32_t n = std::min<uint32_t>(frameCount - done, kMaxFrames);
+                self->render(self->scratch, n);
+                convert::writeFrames(self->scratch, static_cast<uint8_t*>(out) + done * frameBytes, n,
+                                     self->format, self->channels, self->dither);
+                done += n;
+            }
+        };
+        config.pUserData = this;
+
+        if (ma_device_init(nullptr, &config, &device) != MA_SUCCESS)
+        {
+            std::cerr << "音频设备初始化失败\n";
+            return 1;
+        }
+        rate = device.sampleRate;
+        format = device.playback.format;
+        channels = device.playback.channels;
+        playback.configure(rate, device.playback.internalPeriodSizeInFrames * device.playback.internalPeriods);
+
+        if (ma_device_start(&device) != MA_SUCCESS)
+        {
+            std::cerr << "音频设备启动失败\n";
+            ma_device_uninit(&device);
+            return 1;
+        }
+        opened = true;
+        return 0;
+    }
+
+    void close()
+    {
+        if (opened)
+        {
+            ma_device_uninit(&device);
+            opened = false;
+        }
+    }
+
+    [[nodiscard]] uint32_t sampleRate() const { return rate; }
+
+    // Appends a melody to the queue. Returns false if the queue is full.
+    bool enqueue(const ems::Note* notes, size_t count, Waveform waveform = Waveform::Sine, float gain = 1.0f)
+    {
+        const auto id = static_cast<uint32_t>(submitted.fetch_add(1, std::memory_order_relaxed));
+        const Item item{notes, count, waveform, gain, epoch.load(std::memory_order_relaxed), id};
+        if (queue.push(item)) return true;
+        finished.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    template <typename Container>
+    bool enqueue(const Container& notes, Waveform waveform = Waveform::Sine, float gain = 1.0f)
+    {
+        return enqueue(std::data(notes), std::size(notes), waveform, gain);
+    }
+
+    [[nodiscard]] LiveControl& controls() { return live; }
+
+    // Single reader only. Events are dropped (see droppedEvents()) if the reader falls behind.
+    [[nodiscard]] SpscQueue<NoteEvent, EventQueueSize>& events() { return noteEvents; }
+    [[nodiscard]] const PlaybackClock& clock() const { return playback; }
+    [[nodiscard]] uint64_t droppedEvents() const { return dropped.load(std::memory_order_relaxed); }
+
+    // Stops the current melody and drops everything queued before this call.
+    void clear() { epoch.fetch_add(1, std::memory_order_relaxed); }
+
+    // True once every enqueued melody has finished or been cleared.
+    [[nodiscard]] bool idle() const
+    {
+        return finished.load(std::memory_order_acquire) == submitted.load(std::memory_order_relaxed);
+    }
+
+    // Renders `frames` mono frames. Called from the audio callback; public for offline use.
+    void render(float* out, uint32_t frames)
+    {
+        std::memset(out, 0, frames * sizeof(float));
+        const uint32_t now = epoch.load(std::memory_order_relaxed);
+        if (voice.active() && current.epoch != now)
+        {
+            if (voice.sounding()) publish(rendered, NoteEdge::Off, voice.noteIndex());
+            voice.stop();
+            finished.fetch_add(1, std::memory_order_release);
+        }
+
+        // 每个回调块只读取一次控制参数，在本块内逐样本过渡到新值
+        params = live.snapshot();
+        pitch.retarget(params.pitch, frames);
+        volume.retarget(params.volume, frames);
+        if (voice.active()) voice.setWaveform(waveformFor(current));
+
+        uint32_t done = 0;
+        while (done < frames)
+        {
+            if (!voice.active() && !startNext(now)) break; // 队列为空，其余保持静音
+
+            // Pitch is held per call to mix(), so glide in short steps while it is moving.
+            const uint32_t chunk = pitch.left > 0 ? std::min(frames - done, kGlideStep) : frames - done;
+            const uint64_t base = rendered + done;
+            const uint32_t n = voice.mix(out + done, chunk, current.gain, pitch.value,
+                                         [&](uint32_t offset, NoteEdge edge, size_t note)
+                                         {
+                                             publish(base + offset, edge, note);
+                                         });
+            pitch.skip(n);
+            done += n;
+            if (!voice.active()) finished.fetch_add(1, std::memory_order_release);
+        }
+        pitch.skip(frames - done);
+
+        for (uint32_t i = 0; i < frames; ++i) out[i] *= volume.next();
+        rendered += frames;
+    }
+
+private:
+    static constexpr uint32_t kMaxFrames = 4096;
+    static constexpr uint32_t kGlideStep = 32;
+
+    struct Item
+    {
+        const ems::Note* notes = nullptr;
+        size_t count = 0;
+        Waveform waveform = Waveform::Sine;
+        float gain = 1.0f;
+        uint32_t epoch = 0;
+        uint32_t id = 0;
+    };
+
+    void publish(uint64_t frame, NoteEdge edge, size_t note)
+    {
+        const NoteEvent event{frame, current.id, static_cast<uint32_t>(note), current.notes[note].ratio, edge};
+        if (!noteEvents.push(event)) dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    bool startNext(uint32_t now)
+    {
+        Item item;
+        while (queue.pop(item))
+        {
+            if (item.epoch != now || item.count == 0)
+            {
+                finished.fetch_add(1, std::memory_order_release); // 已被 clear() 丢弃
+                continue;
+            }
+            current = item;
+            voice.start(item.notes, item.count, rate, waveformFor(item));
+            return true;
+        }
+        return false;
+    }
+
+    [[nodiscard]] Waveform waveformFor(const Item& item) const
+    {
+        return params.overrideWaveform ? params.waveform : item.waveform;
+    }
+
+    ma_device device{};
+    bool opened = false;
+    uint32_t rate = 48000;
+    ma_format format = ma_format_f32;
+    uint32_t channels = 1;
+    Dither dither;
+    float scratch[kMaxFrames]{};
+
+    MpscQueue<Item, QueueSize> queue;
+    MelodyVoice voice;
+    Item current;
+
+    LiveControl live;
+    LiveControl::Snapshot params{1.0f, 1.0f, false, Waveform::Sine};
+    Ramp pitch;
+    Ramp volume;
+
+    uint64_t rendered = 0; // 自设备启动以来输出的帧数
+    SpscQueue<NoteEvent, EventQueueSize> noteEvents;
+    PlaybackClock playback;
+    std::atomic<uint64_t> dropped{0};
+
+    std::atomic<uint32_t> epoch{0};
+    std::atomic<uint64_t> submitted{0};
+    std::atomic<uint64_t> finished{0};
+};
+
+#endif //EMS_PLAYER_HPP
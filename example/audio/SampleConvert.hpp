@@ -0,0 +1,120 @@
+#ifndef EMS_SAMPLE_CONVERT_HPP
+#define EMS_SAMPLE_CONVERT_HPP
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <miniaudio.h>
+
+/**
+ * @brief TPDF dither source for integer output (xorshift32, no allocation, no locks).
+ * next() returns the sum of two uniform values in [-0.5, 0.5), i.e. a triangular
+ * distribution spanning +-1 LSB once scaled.
+ */
+struct Dither
+{
+    uint32_t state = 0x9E3779B9u;
+
+    float uniform()
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return static_cast<float>(state >> 8) * (1.0f / 16777216.0f) - 0.5f;
+    }
+
+    float next() { return uniform() + uniform(); }
+};
+
+namespace convert
+{
+    // Scales, dithers and clamps one sample to a signed integer of `scale` full range.
+    inline int32_t quantize(const float x, const float scale, Dither& dither)
+    {
+        const float v = std::fmin(std::fmax(x * scale + dither.next(), -scale - 1.0f), scale);
+        return static_cast<int32_t>(std::lrint(v));
+    }
+
+    /**
+     * @brief Writes mono float frames into a device buffer in its native layout.
+     *
+     * Each source sample is converted once and fanned out to every channel, so
+     * miniaudio can pass the buffer to the hardware without its own conversion,
+     * channel mapping or resampling stage. Integer formats get TPDF dither.
+     */
+    inline void writeFrames(const float* src, void* dst, const uint32_t frames, const ma_format format,
+                            const uint32_t channels, Dither& dither)
+    {
+        switch (format)
+        {
+        case ma_format_f32:
+        {
+            auto* out = static_cast<float*>(dst);
+            for (uint32_t i = 0; i < frames; ++i)
+            {
+                for (uint32_t c = 0; c < channels; ++c) out[i * channels + c] = src[i];
+            }
+            break;
+        }
+        case ma_format_s16:
+        {
+            auto* out = static_cast<int16_t*>(dst);
+            for (uint32_t i = 0; i < frames; ++i)
+            {
+                const auto s = static_cast<int16_t>(quantize(src[i], 32767.0f, dither));
+                for (uint32_t c = 0; c < channels; ++c) out[i * channels + c] = s;
+            }
+            break;
+        }
+        case ma_format_s32:
+        {
+            // 32 位整数的 LSB 远低于 float 精度，不加抖动
+            auto* out = static_cast<int32_t*>(dst);
+            for (uint32_t i = 0; i < frames; ++i)
+            {
+                const double v = std::fmin(std::fmax(static_cast<double>(src[i]), -1.0), 1.0) * 2147483647.0;
+                const auto s = static_cast<int32_t>(std::lrint(v));
+                for (uint32_t c = 0; c < channels; ++c) out[i * channels + c] = s;
+            }
+            break;
+        }
+        case ma_format_s24:
+        {
+            auto* out = static_cast<uint8_t*>(dst);
+            for (uint32_t i = 0; i < frames; ++i)
+            {
+                const int32_t s = quantize(src[i], 8388607.0f, dither);
+                for (uint32_t c = 0; c < channels; ++c)
+                {
+                    uint8_t* p = out + (static_cast<size_t>(i) * channels + c) * 3;
+                    p[0] = static_cast<uint8_t>(s);
+                    p[1] = static_cast<uint8_t>(s >> 8);
+                    p[2] = static_cast<uint8_t>(s >> 16);
+                }
+            }
+            break;
+        }
+        case ma_format_u8:
+        {
+            auto* out = static_cast<uint8_t*>(dst);
+            for (uint32_t i = 0; i < frames; ++i)
+            {
+                const auto s = static_cast<uint8_t>(quantize(src[i], 127.0f, dither) + 128);
+                for (uint32_t c = 0; c < channels; ++c) out[i * channels + c] = s;
+            }
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    // Writes silence; for u8 that is 128, not 0.
+    inline void writeSilence(void* dst, const uint32_t frames, const ma_format format, const uint32_t channels)
+    {
+        const size_t bytes = static_cast<size_t>(frames) * channels * ma_get_bytes_per_sample(format);
+        std::memset(dst, format == ma_format_u8 ? 128 : 0, bytes);
+    }
+} // namespace convert
+
+#endif //EMS_SAMPLE_CONVERT_HPP
@@ -0,0 +1,329 @@
+#ifndef EMS_SEQUENCE_HPP
+#define EMS_SEQUENCE_HPP
+
+#include <array>
+#include <atomic>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "Audio.hpp"
+
+/**
+ * @brief Fire-and-forget coroutine used to script a sequence of melodies and events.
+ *
+ * A SeqTask starts suspended and is handed to SequencePlayer::spawn(), which resumes
+ * it on the player's executor. The frame destroys itself once the body returns.
+ *
+ *   SeqTask blink(SequencePlayer& player)
+ *   {
+ *       const auto song = player.start(melody);
+ *       co_await song.until_note(4);
+ *       led_on();
+ *       co_await player.delay_ms(200);
+ *       led_off();
+ *   }
+ */
+struct SeqTask
+{
+    struct promise_type
+    {
+        SeqTask get_return_object() { return SeqTask{std::coroutine_handle<promise_type>::from_promise(*this)}; }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    SeqTask() = default;
+    explicit SeqTask(std::coroutine_handle<promise_type> h) : handle(h) {}
+    SeqTask(SeqTask&& other) noexcept : handle(std::exchange(other.handle, {})) {}
+    SeqTask& operator=(SeqTask&& other) noexcept
+    {
+        if (this != &other)
+        {
+            if (handle) handle.destroy();
+            handle = std::exchange(other.handle, {});
+        }
+        return *this;
+    }
+    SeqTask(const SeqTask&) = delete;
+    SeqTask& operator=(const SeqTask&) = delete;
+    ~SeqTask() { if (handle) handle.destroy(); }
+
+    std::coroutine_handle<> release() { return std::exchange(handle, {}); }
+
+private:
+    std::coroutine_handle<promise_type> handle{};
+};
+
+/**
+ * @brief Single-threaded executor whose notion of "now" is the audio clock.
+ *
+ * Suspended coroutines are kept in a min-heap keyed by the frame at which they
+ * should resume. poll() resumes everything that is due; it must always be called
+ * from the same (non-audio) thread.
+ */
+class SeqExecutor
+{
+public:
+    SeqExecutor() = default;
+    SeqExecutor(const SeqExecutor&) = delete;
+    SeqExecutor& operator=(const SeqExecutor&) = delete;
+
+    ~SeqExecutor()
+    {
+        while (!timers.empty())
+        {
+            timers.top().handle.destroy();
+            timers.pop();
+        }
+    }
+
+    void scheduleAt(uint64_t frame, std::coroutine_handle<> h)
+    {
+        timers.push(Timer{frame, nextSeq++, h});
+    }
+
+    // Resumes every coroutine due at or before `now`. Returns the number resumed.
+    size_t poll(uint64_t now)
+    {
+        size_t resumed = 0;
+        while (!timers.empty() && timers.top().frame <= now)
+        {
+            const auto h = timers.top().handle;
+            timers.pop();
+            h.resume();
+            resumed++;
+        }
+        return resumed;
+    }
+
+    [[nodiscard]] bool idle() const { return timers.empty(); }
+
+    // Frame of the earliest pending wakeup, or UINT64_MAX when idle.
+    [[nodiscard]] uint64_t nextDeadline() const { return timers.empty() ? UINT64_MAX : timers.top().frame; }
+
+private:
+    struct Timer
+    {
+        uint64_t frame;
+        uint64_t seq; // 同一时刻按提交顺序恢复
+        std::coroutine_handle<> handle;
+
+        bool operator>(const Timer& o) const { return frame != o.frame ? frame > o.frame : seq > o.seq; }
+    };
+
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<>> timers;
+    uint64_t nextSeq = 0;
+};
+
+/**
+ * @brief Persistent playback device with coroutine awaitables for sequencing.
+ *
+ * The audio callback mixes up to MaxVoices melodies and advances a frame counter;
+ * that counter is the only clock the awaitables use, so LED/haptic events line up
+ * with what has actually been rendered. Melodies are rendered with generatePCM()
+ * on the calling thread, so timing is identical to playMelody().
+ */
+template <size_t MaxVoices = 16>
+class SequencePlayer
+{
+public:
+    explicit SequencePlayer(uint32_t sampleRate = 48000) : rate(sampleRate) {}
+
+    SequencePlayer(const SequencePlayer&) = delete;
+    SequencePlayer& operator=(const SequencePlayer&) = delete;
+
+    ~SequencePlayer() { stop(); }
+
+    int open()
+    {
+        ma_device_config config = ma_device_config_init(ma_device_type_playback);
+        config.playback.format = ma_format_f32;
+        config.playback.channels = 1;
+        config.sampleRate = rate;
+        config.dataCallback = [](ma_device* device, void* out, const void*, ma_uint32 frameCount)
+        {
+            static_cast<SequencePlayer*>(device->pUserData)->render(static_cast<float*>(out), frameCount);
+        };
+        config.pUserData = this;
+
+        if (ma_device_init(nullptr, &config, &device) != MA_SUCCESS)
+        {
+            std::cerr << "音频设备初始化失败\n";
+            return 1;
+        }
+        if (ma_device_start(&device) != MA_SUCCESS)
+        {
+            std::cerr << "音频设备启动失败\n";
+            ma_device_uninit(&device);
+            return 1;
+        }
+        opened = true;
+        return 0;
+    }
+
+    void stop()
+    {
+        if (opened)
+        {
+            ma_device_uninit(&device);
+            opened = false;
+        }
+    }
+
+    void spawn(SeqTask task) { executor.scheduleAt(now(), task.release()); }
+
+    // Runs all sequences that are due. Call this from the UI/main loop.
+    size_t poll() { return executor.poll(now()); }
+
+    [[nodiscard]] bool idle() const { return executor.idle(); }
+    [[nodiscard]] uint64_t now() const { return clock.load(std::memory_order_acquire); }
+    [[nodiscard]] uint64_t nextDeadline() const { return executor.nextDeadline(); }
+    [[nodiscard]] uint32_t sampleRate() const { return rate; }
+
+    struct WaitUntil
+    {
+        SeqExecutor& executor;
+        uint64_t frame;
+        uint64_t current;
+
+        [[nodiscard]] bool await_ready() const noexcept { return frame <= current; }
+        void await_suspend(std::coroutine_handle<> h) const { executor.scheduleAt(frame, h); }
+        void await_resume() const noexcept {}
+    };
+
+    /**
+     * @brief One started melody: its own note timeline, unaffected by later start() calls.
+     */
+    class Playback
+    {
+    public:
+        // co_await song.until_note(i): resumes when note i of this melody begins.
+        WaitUntil until_note(size_t index) const
+        {
+            const uint64_t frame = index < offsets.size() ? offsets[index] : end;
+            return WaitUntil{player->executor, frame, player->now()};
+        }
+
+        // co_await song.until_end(): resumes when this melody has finished.
+        WaitUntil until_end() const { return WaitUntil{player->executor, end, player->now()}; }
+
+        // Audio frame at which the melody ends.
+        [[nodiscard]] uint64_t endFrame() const { return end; }
+
+    private:
+        friend class SequencePlayer;
+
+        Playback(SequencePlayer& player, std::vector<uint64_t> offsets, uint64_t end)
+            : player(&player), offsets(std::move(offsets)), end(end)
+        {
+        }
+
+        SequencePlayer* player;
+        std::vector<uint64_t> offsets;
+        uint64_t end;
+    };
+
+    /**
+     * @brief Starts a melody without waiting for it.
+     * @return A handle whose until_note() / until_end() refer to this melody only.
+     */
+    template <typename Container>
+    Playback start(const Container& notes)
+    {
+        const uint64_t begin = now();
+        Voice* v = acquireVoice();
+
+        // Note offsets follow generatePCM() exactly: samples per note + 1ms gap.
+        std::vector<uint64_t> offsets;
+        uint64_t offset = 0;
+        for (const auto& n : notes)
+        {
+            offsets.push_back(begin + offset);
+            offset += static_cast<uint64_t>(n.duration_ms) * rate / 1000 + rate / 1000;
+        }
+
+        if (v != nullptr)
+        {
+            generatePCM(notes, v->pcm, rate);
+            v->startFrame = begin;
+            v->state.store(Voice::Playing, std::memory_order_release);
+        }
+        return Playback(*this, std::move(offsets), begin + offset);
+    }
+
+    // co_await player.play(melody): starts the melody and resumes when it has finished.
+    template <typename Container>
+    WaitUntil play(const Container& notes)
+    {
+        return start(notes).until_end();
+    }
+
+    WaitUntil delay_ms(uint32_t ms)
+    {
+        const uint64_t t = now();
+        return WaitUntil{executor, t + static_cast<uint64_t>(ms) * rate / 1000, t};
+    }
+
+    // Advances the clock by mixing `frameCount` frames. Called from the audio callback.
+    void render(float* dst, uint32_t frameCount)
+    {
+        std::memset(dst, 0, frameCount * sizeof(float));
+        const uint64_t base = clock.load(std::memory_order_relaxed);
+
+        for (auto& v : voices)
+        {
+            if (v.state.load(std::memory_order_acquire) != Voice::Playing) continue;
+
+            // 声音可能在上一次回调期间提交，跳过已错过的帧以保持时间线
+            const uint64_t from = v.startFrame > base ? v.startFrame - base : 0;
+            const uint64_t cursor = base + from - v.startFrame;
+            const size_t total = v.pcm.size();
+            size_t i = 0;
+            for (; from + i < frameCount && cursor + i < total; ++i)
+            {
+                dst[from + i] += v.pcm[cursor + i];
+            }
+            if (cursor + i >= total)
+            {
+                v.state.store(Voice::Free, std::memory_order_release);
+            }
+        }
+        clock.store(base + frameCount, std::memory_order_release);
+    }
+
+private:
+    struct Voice
+    {
+        enum : uint8_t { Free, Playing };
+
+        std::atomic<uint8_t> state{Free};
+        uint64_t startFrame = 0;
+        std::vector<float> pcm; // capacity is reused between melodies
+    };
+
+    Voice* acquireVoice()
+    {
+        for (auto& v : voices)
+        {
+            if (v.state.load(std::memory_order_acquire) == Voice::Free) return &v;
+        }
+        return nullptr; // all voices busy: timing still advances, melody is silent
+    }
+
+    uint32_t rate;
+    ma_device device{};
+    bool opened = false;
+
+    std::atomic<uint64_t> clock{0};
+    std::array<Voice, MaxVoices> voices{};
+    SeqExecutor executor;
+};
+
+#endif //EMS_SEQUENCE_HPP
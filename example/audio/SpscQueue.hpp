@@ -0,0 +1,61 @@
+#ifndef EMS_SPSC_QUEUE_HPP
+#define EMS_SPSC_QUEUE_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @brief Bounded lock-free single-producer / single-consumer ring buffer.
+ *
+ * Used for traffic out of the audio callback: the callback pushes, one reader thread
+ * pops. Each side owns one index and only reads the other, so a transfer costs one
+ * acquire load and one release store. push() fails instead of waiting when full.
+ */
+template <typename T, size_t Capacity>
+class SpscQueue
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    SpscQueue() = default;
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Producer thread only.
+    bool push(const T& value)
+    {
+        const size_t t = tail.load(std::memory_order_relaxed);
+        if (t - headCache == Capacity)
+        {
+            headCache = head.load(std::memory_order_acquire);
+            if (t - headCache == Capacity) return false; // full
+        }
+        cells[t & (Capacity - 1)] = value;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer thread only.
+    bool pop(T& out)
+    {
+        const size_t h = head.load(std::memory_order_relaxed);
+        if (h == tailCache)
+        {
+            tailCache = tail.load(std::memory_order_acquire);
+            if (h == tailCache) return false;
+        }
+        out = cells[h & (Capacity - 1)];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    std::array<T, Capacity> cells{};
+    alignas(64) std::atomic<size_t> tail{0};
+    size_t headCache = 0; // 生产者缓存的 head
+    alignas(64) std::atomic<size_t> head{0};
+    size_t tailCache = 0; // 消费者缓存的 tail
+};
+
+#endif //EMS_SPSC_QUEUE_HPP
@@ -0,0 +1,174 @@
+#ifndef EMS_THREAD_POOL_HPP
+#define EMS_THREAD_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Fixed-size work-stealing thread pool for offline rendering.
+ *
+ * Every worker owns a deque: it pushes and pops at the back, idle workers steal
+ * from the front of the others. Submissions from outside the pool are spread
+ * round-robin. Tasks are coarse (a range of notes, a whole score), so a mutex
+ * per deque is cheap next to the work it guards.
+ */
+class WorkStealingPool
+{
+public:
+    explicit WorkStealingPool(size_t threads = std::thread::hardware_concurrency())
+    {
+        threads = std::max<size_t>(threads, 1);
+        queues.reserve(threads);
+        for (size_t i = 0; i < threads; ++i) queues.push_back(std::make_unique<Queue>());
+        workers.reserve(threads);
+        for (size_t i = 0; i < threads; ++i)
+        {
+            workers.emplace_back([this, i] { workerLoop(i); });
+        }
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    ~WorkStealingPool()
+    {
+        {
+            std::lock_guard lock(sleepMutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& w : workers) w.join();
+    }
+
+    [[nodiscard]] size_t size() const { return workers.size(); }
+
+    // Index of the calling worker, or size() when called from outside the pool.
+    [[nodiscard]] size_t currentWorker() const { return self == this ? selfIndex : queues.size(); }
+
+    void submit(std::function<void()> task)
+    {
+        const size_t target = currentWorker() < queues.size()
+                                  ? currentWorker()
+                                  : nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+        {
+            // 先计数再入队，避免计数被先出队的 worker 减成负数
+            std::lock_guard lock(sleepMutex);
+            pending++;
+        }
+        {
+            std::lock_guard lock(queues[target]->mutex);
+            queues[target]->tasks.push_back(std::move(task));
+        }
+        wake.notify_one();
+    }
+
+    /**
+     * @brief Runs `f(begin, end)` over [0, count) in `chunks` pieces and waits for all of them.
+     * `f` must be safe to call concurrently on disjoint ranges. Blocks the caller,
+     * so it must not be called from inside a pool task.
+     */
+    template <typename F>
+    void parallelFor(const size_t count, size_t chunks, F&& f)
+    {
+        if (count == 0) return;
+        chunks = std::clamp<size_t>(chunks, 1, count);
+
+        size_t remaining = chunks;
+        std::mutex doneMutex;
+        std::condition_variable done;
+
+        for (size_t c = 0; c < chunks; ++c)
+        {
+            const size_t begin = count * c / chunks;
+            const size_t end = count * (c + 1) / chunks;
+            submit([&, begin, end]
+            {
+                f(begin, end);
+                // 在锁内计数并通知，保证等待方返回时不再有任务访问这些局部变量
+                std::lock_guard lock(doneMutex);
+                if (--remaining == 0) done.notify_all();
+            });
+        }
+
+        std::unique_lock lock(doneMutex);
+        done.wait(lock, [&] { return remaining == 0; });
+    }
+
+private:
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    bool popLocal(const size_t index, std::function<void()>& out)
+    {
+        auto& q = *queues[index];
+        std::lock_guard lock(q.mutex);
+        if (q.tasks.empty()) return false;
+        out = std::move(q.tasks.back());
+        q.tasks.pop_back();
+        return true;
+    }
+
+    bool steal(const size_t thief, std::function<void()>& out)
+    {
+        for (size_t k = 1; k < queues.size(); ++k)
+        {
+            auto& q = *queues[(thief + k) % queues.size()];
+            std::lock_guard lock(q.mutex);
+            if (q.tasks.empty()) continue;
+            out = std::move(q.tasks.front());
+            q.tasks.pop_front();
+            return true;
+        }
+        return false;
+    }
+
+    void workerLoop(const size_t index)
+    {
+        self = this;
+        selfIndex = index;
+
+        std::function<void()> task;
+        while (true)
+        {
+            if (popLocal(index, task) || steal(index, task))
+            {
+                {
+                    std::lock_guard lock(sleepMutex);
+                    pending--;
+                }
+                task();
+                task = nullptr;
+                continue;
+            }
+
+            std::unique_lock lock(sleepMutex);
+            wake.wait(lock, [this] { return stopping || pending > 0; });
+            if (stopping && pending == 0) return;
+        }
+    }
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<size_t> nextQueue{0};
+
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    size_t pending = 0;
+    bool stopping = false;
+
+    static inline thread_local const WorkStealingPool* self = nullptr;
+    static inline thread_local size_t selfIndex = 0;
+};
+
+#endif //EMS_THREAD_POOL_HPP
@@ -0,0 +1,141 @@
+#ifndef EMS_TICK_STREAM_HPP
+#define EMS_TICK_STREAM_HPP
+
+#include <algorithm>
+
+#include "Audio.hpp"
+#include "ems_tempo.hpp"
+
+/**
+ * @brief Pull-based renderer for `_ems_ticks` scores with a live tempo.
+ *
+ * Each note ends exactly when the TickClock reaches its end tick, so note boundaries
+ * stay on the beat grid however long the song loops. The 1 ms gap between notes is
+ * taken from the end of each note rather than added after it, for the same reason.
+ * Notes are synthesised block by block as they are read (oscillator phase and
+ * position in the note are carried between blocks), so setTempo()/rampTempo() take
+ * effect immediately without re-rendering anything: only the sounding note's length
+ * and envelope plan are recomputed from its remaining ticks, and it still ends on its
+ * end tick. Samples already played stay as they were.
+ *
+ *   constexpr auto song = "(120)1,2,3,4,"_ems_ticks;
+ *   TickStream<decltype(song)> stream(song, 48000);
+ *   stream.rampTempo(150.0f, 2000);
+ */
+template <typename Score>
+class TickStream
+{
+public:
+    explicit TickStream(const Score& score, uint32_t sampleRate = 48000, Waveform waveform = Waveform::Sine,
+                        const Envelope& envelope = {}, bool loop = false)
+        : score(score), clock(sampleRate, static_cast<float>(score.bpm)), waveform(waveform), envelope(envelope),
+          loop(loop)
+    {
+    }
+
+    [[nodiscard]] bool done() const { return index == score.size() && pos == length; }
+    [[nodiscard]] float tempo() const { return clock.tempo(); }
+
+    // Tempos <= 0 are ignored; a stopped clock would make the current note endless.
+    void setTempo(float bpm)
+    {
+        if (bpm <= 0.0f) return;
+        clock.set_tempo(bpm);
+        retime();
+    }
+
+    void rampTempo(float bpm, uint32_t durationMs)
+    {
+        if (bpm <= 0.0f) return;
+        clock.ramp_tempo(bpm, noteSamples(durationMs, clock.sample_rate()));
+        retime();
+    }
+
+    // Writes up to `frames` mono samples to dst and returns how many were written (0 at the end).
+    size_t read(float* dst, size_t frames)
+    {
+        size_t written = 0;
+        while (written < frames)
+        {
+            if (pos == length && !advance()) break;
+
+            const auto n = static_cast<uint32_t>(std::min<size_t>(frames - written, length - pos));
+            renderSpan(dst + written, n);
+            pos += n;
+            written += n;
+            clock.advance(n);
+        }
+        return written;
+    }
+
+private:
+    // Starts the next note, sized so it ends on its end tick.
+    bool advance()
+    {
+        constexpr double baseFreq = 440.0; // A4
+
+        if (index == score.size())
+        {
+            if (!loop || score.size() == 0) return false;
+            index = 0;
+        }
+
+        playing = index++;
+        const auto& n = score[playing];
+        endTick += n.ticks;
+
+        // 时钟已越过结束 tick（不应发生）时从当前位置重新对齐，音符仍完整播放
+        if (n.ticks > 0 && clock.ticks() >= endTick) endTick = clock.ticks() + n.ticks;
+
+        freq = baseFreq * n.ratio;
+        phase = 0.0;
+        pos = 0;
+        fit(static_cast<uint32_t>(clock.samples_to(endTick)));
+        return true;
+    }
+
+    // Fits the sounding note to its end tick at the current tempo; nothing is re-rendered.
+    void retime()
+    {
+        if (pos == length) return; // 处于音符边界，下一个音符会按新速度计算
+        fit(static_cast<uint32_t>(pos + clock.samples_to(endTick)));
+    }
+
+    // Sets the note to `samples` frames whose last 1 ms is the gap, and plans its envelope.
+    void fit(uint32_t samples)
+    {
+        constexpr float amplitude = 0.2f;
+        length = samples;
+        sounding = samples - std::min(noteGap(clock.sample_rate()), samples);
+        plan = env::plan(noteEnvelope(score[playing], envelope), sounding, clock.sample_rate(), amplitude);
+    }
+
+    // Synthesises note samples [pos, pos + count) into out.
+    void renderSpan(float* out, uint32_t count)
+    {
+        const uint32_t tone = pos < sounding ? std::min(count, sounding - pos) : 0;
+        osc::renderWave(waveform, out, tone, freq, clock.sample_rate(), phase);
+        phase = osc::advancePhase(phase, tone, freq, clock.sample_rate());
+        env::applyRange(plan, out, pos, tone);
+        std::fill(out + tone, out + count, 0.0f); // 音符末尾的间隙
+    }
+
+    const Score& score;
+    ems::TickClock clock;
+    Waveform waveform;
+    Envelope envelope;
+    bool loop;
+
+    size_t index = 0;
+    size_t playing = 0;
+    uint64_t endTick = 0;
+
+    uint32_t pos = 0; ///< Samples of the current note already read.
+    uint32_t length = 0; ///< Current note length in samples, gap included.
+    uint32_t sounding = 0; ///< Samples before the gap.
+    double freq = 0.0;
+    double phase = 0.0;
+    env::Plan plan{};
+};
+
+#endif //EMS_TICK_STREAM_HPP
@@ -0,0 +1,41 @@
+#ifndef EMS_TRACK_RENDER_HPP
+#define EMS_TRACK_RENDER_HPP
+
+#include <vector>
+
+#include "ems_timeline.hpp"
+#include "Audio.hpp"
+
+/**
+ * @brief generatePCM() for merged multi-track scores (ems::tracks()).
+ *
+ * One cursor walks the flat event array in order; each event is rendered with
+ * renderNote() and summed in at its absolute start time, so notes of different
+ * tracks overlap. Timing follows `start_ms` exactly (no inter-note gap is added;
+ * the envelope fades separate consecutive notes of a track).
+ */
+template <typename Container>
+static void generatePCMTracks(const Container& events, std::vector<float>& pcm, uint32_t sampleRate = 48000,
+                              Waveform waveform = Waveform::Sine, const Envelope& envelope = {})
+{
+    uint32_t lengthMs = 0;
+    for (const ems::Event& e : events)
+    {
+        lengthMs = e.start_ms + e.duration_ms > lengthMs ? e.start_ms + e.duration_ms : lengthMs;
+    }
+    pcm.assign(noteSamples(lengthMs, sampleRate), 0.0f);
+
+    std::vector<float> note;
+    for (const ems::Event& e : events)
+    {
+        const uint32_t samples = noteSamples(e.duration_ms, sampleRate);
+        note.resize(samples);
+        renderNote(ems::Note{e.ratio, e.duration_ms}, note.data(), samples, sampleRate, waveform, envelope);
+
+        // floor(a) + floor(b) <= floor(a + b)，不会越界
+        float* out = pcm.data() + noteSamples(e.start_ms, sampleRate);
+        for (uint32_t i = 0; i < samples; ++i) out[i] += note[i];
+    }
+}
+
+#endif //EMS_TRACK_RENDER_HPP
@@ -0,0 +1,140 @@
+#ifndef EMS_VOICE_HPP
+#define EMS_VOICE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "ems_parser.hpp"
+#include "Audio.hpp"
+
+enum class NoteEdge : uint8_t
+{
+    On,  ///< The note starts sounding.
+    Off, ///< The note stops sounding (its release has finished); the gap follows.
+};
+
+/**
+ * @brief Real-time melody voice: synthesises notes block by block inside the audio callback.
+ *
+ * Nothing is pre-rendered and nothing is allocated; the voice keeps a pointer to the
+ * notes (which must outlive playback, e.g. a constexpr `_ems` array), the position in
+ * the current note, the oscillator phase and the note's envelope plan. Timing matches
+ * generatePCM(): each note is followed by the same 1ms gap.
+ */
+class MelodyVoice
+{
+public:
+    static constexpr uint32_t kBlock = 256;
+
+    void start(const ems::Note* melody, size_t count, uint32_t sampleRate, Waveform shape = Waveform::Sine,
+               const Envelope& adsr = {})
+    {
+        notes = count > 0 ? melody : nullptr;
+        noteCount = count;
+        rate = sampleRate;
+        waveform = shape;
+        envelope = adsr;
+        index = 0;
+        if (notes != nullptr) enterNote();
+    }
+
+    void stop() { notes = nullptr; }
+
+    // Switches the oscillator shape mid-note; the phase carries over, so there is no jump in time.
+    void setWaveform(Waveform shape) { waveform = shape; }
+
+    [[nodiscard]] bool active() const { return notes != nullptr; }
+    [[nodiscard]] size_t noteIndex() const { return index; }
+    // Between a NoteEdge::On and its NoteEdge::Off.
+    [[nodiscard]] bool sounding() const { return notes != nullptr && announced && pos < noteLength; }
+
+    /**
+     * @brief Adds up to `frames` samples, scaled by `gain`, onto `out`.
+     * `pitch` multiplies every note's frequency (live transpose); it is held for the whole call.
+     * @return Frames produced; fewer than `frames` means the melody ended inside this block.
+     */
+    uint32_t mix(float* out, uint32_t frames, float gain, float pitch = 1.0f)
+    {
+        return mix(out, frames, gain, pitch, [](uint32_t, NoteEdge, size_t) {});
+    }
+
+    /**
+     * @brief mix() that also reports note boundaries.
+     * `onEdge(offset, edge, noteIndex)` is called at the exact frame offset into `out`
+     * where each note starts / stops.
+     */
+    template <typename OnEdge>
+    uint32_t mix(float* out, uint32_t frames, float gain, float pitch, OnEdge&& onEdge)
+    {
+        uint32_t done = 0;
+        while (done < frames && notes != nullptr)
+        {
+            if (pos == 0 && !announced)
+            {
+                announced = true;
+                onEdge(done, NoteEdge::On, index);
+                if (noteLength == 0) onEdge(done, NoteEdge::Off, index);
+            }
+
+            uint32_t n;
+            if (pos < noteLength)
+            {
+                n = std::min({frames - done, noteLength - pos, kBlock});
+                float buf[kBlock];
+                const double f = freq * pitch;
+                osc::renderWave(waveform, buf, n, f, rate, phase);
+                phase = osc::advancePhase(phase, n, f, rate);
+                env::applyRange(plan, buf, pos, n);
+                for (uint32_t i = 0; i < n; ++i) out[done + i] += gain * buf[i];
+                if (pos + n == noteLength) onEdge(done + n, NoteEdge::Off, index);
+            }
+            else
+            {
+                n = std::min(frames - done, slotLength - pos); // 音符间隙
+            }
+            pos += n;
+            done += n;
+
+            if (pos == slotLength)
+            {
+                if (++index == noteCount) notes = nullptr;
+                else enterNote();
+            }
+        }
+        return done;
+    }
+
+private:
+    void enterNote()
+    {
+        constexpr double baseFreq = 440.0; // A4
+        constexpr float amplitude = 0.2f;
+        const ems::Note& n = notes[index];
+        noteLength = noteSamples(n.duration_ms, rate);
+        slotLength = noteLength + noteGap(rate);
+        freq = baseFreq * n.ratio;
+        phase = 0.0;
+        pos = 0;
+        announced = false;
+        plan = env::plan(noteEnvelope(n, envelope), noteLength, rate, amplitude);
+    }
+
+    const ems::Note* notes = nullptr;
+    size_t noteCount = 0;
+    size_t index = 0;
+
+    uint32_t rate = 48000;
+    Waveform waveform = Waveform::Sine;
+    Envelope envelope{};
+
+    uint32_t pos = 0;
+    uint32_t noteLength = 0;
+    uint32_t slotLength = 0;
+    bool announced = false;
+    double freq = 0.0;
+    double phase = 0.0;
+    env::Plan plan{};
+};
+
+#endif //EMS_VOICE_HPP
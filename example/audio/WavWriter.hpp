@@ -0,0 +1,238 @@
+#ifndef EMS_WAV_WRITER_HPP
+#define EMS_WAV_WRITER_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "PcmStream.hpp"
+
+enum class SampleFormat : uint8_t
+{
+    F32,
+    S16,
+};
+
+/**
+ * @brief Streaming WAV file sink (POSIX).
+ *
+ * Samples are converted into one aligned staging buffer and written with large
+ * pwrite() calls. The header is padded with a JUNK chunk so that the audio data
+ * starts at offset 4096; every full block is therefore page-aligned, which is what
+ * O_DIRECT needs when `direct` is requested (Linux). Chunk sizes are patched in
+ * close(), so the total length does not need to be known up front.
+ */
+class WavWriter
+{
+public:
+    static constexpr size_t kAlign = 4096;
+    static constexpr size_t kDataOffset = kAlign;
+
+    WavWriter() = default;
+    WavWriter(const WavWriter&) = delete;
+    WavWriter& operator=(const WavWriter&) = delete;
+    ~WavWriter()
+    {
+        close();
+        std::free(buffer);
+    }
+
+    bool open(const char* path, uint32_t sampleRate, uint16_t channels = 1, SampleFormat format = SampleFormat::F32,
+              bool direct = false, size_t bufferBytes = size_t{1} << 20)
+    {
+        close();
+        rate = sampleRate;
+        channelCount = channels;
+        sampleFormat = format;
+        // 同一个 writer 连续写多个文件时复用暂存缓冲
+        const size_t wanted = std::max(kAlign, bufferBytes / kAlign * kAlign);
+        if (buffer == nullptr || capacity != wanted)
+        {
+            std::free(buffer);
+            capacity = wanted;
+            buffer = static_cast<uint8_t*>(std::aligned_alloc(kAlign, capacity));
+            if (buffer == nullptr) return false;
+        }
+
+        int flags = O_WRONLY | O_CREAT | O_TRUNC;
+#ifdef O_DIRECT
+        if (direct) flags |= O_DIRECT;
+#else
+        (void)direct;
+#endif
+        fd = ::open(path, flags, 0644);
+        if (fd < 0) return false;
+
+        // 先写入占位头，close() 时回填长度
+        offset = kDataOffset;
+        fill = 0;
+        dataBytes = 0;
+        return writeHeader();
+    }
+
+    [[nodiscard]] bool isOpen() const { return fd >= 0; }
+
+    // Appends `frames` interleaved frames (frames * channels floats).
+    bool write(const float* samples, size_t frames)
+    {
+        size_t count = frames * channelCount;
+        const size_t bytesPerSample = sampleFormat == SampleFormat::F32 ? 4 : 2;
+
+        while (count > 0)
+        {
+            const size_t n = std::min(count, (capacity - fill) / bytesPerSample);
+            if (sampleFormat == SampleFormat::F32)
+            {
+                std::memcpy(buffer + fill, samples, n * sizeof(float));
+            }
+            else
+            {
+                auto* out = reinterpret_cast<int16_t*>(buffer + fill);
+                for (size_t i = 0; i < n; ++i)
+                {
+                    const float s = std::clamp(samples[i], -1.0f, 1.0f);
+                    out[i] = static_cast<int16_t>(std::lrint(s * 32767.0f));
+                }
+            }
+            fill += n * bytesPerSample;
+            samples += n;
+            count -= n;
+
+            if (fill == capacity && !flush()) return false;
+        }
+        return true;
+    }
+
+    // Writes the tail, patches the header and closes the file.
+    bool close()
+    {
+        if (fd < 0) return true;
+
+        bool ok = true;
+        if (fill > 0)
+        {
+            // 末尾不足对齐块，关闭 O_DIRECT 后普通写入
+#ifdef O_DIRECT
+            ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) & ~O_DIRECT);
+#endif
+            ok = ::pwrite(fd, buffer, fill, static_cast<off_t>(offset)) == static_cast<ssize_t>(fill);
+            offset += fill;
+            dataBytes += fill;
+            fill = 0;
+        }
+        ok = writeHeader() && ok;
+        ok = ::close(fd) == 0 && ok;
+        fd = -1;
+        return ok;
+    }
+
+private:
+    bool flush()
+    {
+        if (::pwrite(fd, buffer, fill, static_cast<off_t>(offset)) != static_cast<ssize_t>(fill)) return false;
+        offset += fill;
+        dataBytes += fill;
+        fill = 0;
+        return true;
+    }
+
+    bool writeHeader()
+    {
+        // 头部单独占一个对齐块，借用（此时为空的）暂存缓冲写出，O_DIRECT 下同样适用
+        uint8_t* header = buffer;
+        std::memset(header, 0, kAlign);
+
+        size_t pos = 0;
+        const auto tag = [&](const char* s) { std::memcpy(header + pos, s, 4); pos += 4; };
+        const auto u32 = [&](uint32_t v) { for (int i = 0; i < 4; ++i) header[pos++] = static_cast<uint8_t>(v >> (8 * i)); };
+        const auto u16 = [&](uint16_t v) { header[pos++] = static_cast<uint8_t>(v); header[pos++] = static_cast<uint8_t>(v >> 8); };
+
+        const bool isFloat = sampleFormat == SampleFormat::F32;
+        const uint16_t bits = isFloat ? 32 : 16;
+        const uint16_t blockAlign = static_cast<uint16_t>(channelCount * bits / 8);
+        const auto data32 = static_cast<uint32_t>(std::min<uint64_t>(dataBytes, UINT32_MAX - kDataOffset));
+
+        tag("RIFF");
+        u32(static_cast<uint32_t>(kDataOffset - 8 + data32));
+        tag("WAVE");
+
+        tag("fmt ");
+        u32(isFloat ? 18 : 16);
+        u16(isFloat ? 3 : 1); // WAVE_FORMAT_IEEE_FLOAT / WAVE_FORMAT_PCM
+        u16(channelCount);
+        u32(rate);
+        u32(rate * blockAlign);
+        u16(blockAlign);
+        u16(bits);
+        if (isFloat)
+        {
+            u16(0); // cbSize
+            tag("fact");
+            u32(4);
+            u32(blockAlign ? data32 / blockAlign : 0);
+        }
+
+        // JUNK 填充，使 data 从 kDataOffset 开始
+        tag("JUNK");
+        u32(static_cast<uint32_t>(kDataOffset - 8 - (pos + 4)));
+        pos = kDataOffset - 8;
+        tag("data");
+        u32(data32);
+
+        return ::pwrite(fd, header, kAlign, 0) == static_cast<ssize_t>(kAlign);
+    }
+
+    int fd = -1;
+    uint8_t* buffer = nullptr;
+    size_t capacity = 0;
+    size_t fill = 0;
+    uint64_t offset = 0;
+    uint64_t dataBytes = 0;
+
+    uint32_t rate = 48000;
+    uint16_t channelCount = 1;
+    SampleFormat sampleFormat = SampleFormat::F32;
+};
+
+/**
+ * @brief Renders a melody straight into a mono WAV file in `blockFrames`-sized blocks.
+ * Memory use is independent of the song length.
+ */
+template <typename Container>
+static int renderToWav(const Container& notes, const char* path, uint32_t sampleRate = 48000,
+                       SampleFormat format = SampleFormat::F32, Waveform waveform = Waveform::Sine,
+                       const Envelope& envelope = {}, bool direct = false, size_t blockFrames = 16384)
+{
+    WavWriter writer;
+    if (!writer.open(path, sampleRate, 1, format, direct))
+    {
+        std::cerr << "WAV 文件打开失败: " << path << "\n";
+        return 1;
+    }
+
+    PcmStream<Container> stream(notes, sampleRate, waveform, envelope);
+    std::vector<float> block(blockFrames);
+    while (const size_t n = stream.read(block.data(), block.size()))
+    {
+        if (!writer.write(block.data(), n))
+        {
+            std::cerr << "WAV 文件写入失败: " << path << "\n";
+            return 1;
+        }
+    }
+    if (!writer.close())
+    {
+        std::cerr << "WAV 文件写入失败: " << path << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+#endif //EMS_WAV_WRITER_HPP
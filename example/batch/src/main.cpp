@@ -0,0 +1,84 @@
+#include "ems_parser.hpp"
+#include "BatchRender.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+static bool readFile(const fs::path& path, std::string& out)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    std::ostringstream ss;
+    ss << in.rdbuf();
+    out = ss.str();
+    return true;
+}
+
+// Usage: ems_example_batch [-j threads] [-o outdir] [--f32] score.ems... [@list.txt]
+// A @file argument names a text file with one score path per line.
+int main(int argc, char** argv)
+{
+    size_t threads = std::thread::hardware_concurrency();
+    fs::path outDir = ".";
+    SampleFormat format = SampleFormat::S16;
+    std::vector<fs::path> inputs;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "-j") == 0 && i + 1 < argc) threads = std::strtoul(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "-o") == 0 && i + 1 < argc) outDir = argv[++i];
+        else if (std::strcmp(argv[i], "--f32") == 0) format = SampleFormat::F32;
+        else if (argv[i][0] == '@')
+        {
+            std::ifstream list(argv[i] + 1);
+            for (std::string line; std::getline(list, line);)
+            {
+                if (!line.empty()) inputs.emplace_back(line);
+            }
+        }
+        else inputs.emplace_back(argv[i]);
+    }
+
+    std::vector<BatchJob> jobs;
+    jobs.reserve(inputs.size());
+    std::string text;
+    size_t skipped = 0; // 读不到或速度无效的乐谱，也算作失败
+    for (const auto& path : inputs)
+    {
+        if (!readFile(path, text))
+        {
+            std::cerr << "无法读取乐谱: " << path << "\n";
+            skipped++;
+            continue;
+        }
+        BatchJob job;
+        job.outputPath = (outDir / path.stem()).string() + ".wav";
+        job.notes.resize(ems::count_notes(text));
+        job.notes.resize(ems::parse(text, job.notes.data(), job.notes.size()));
+        if (job.notes.empty() && ems::count_notes(text) > 0)
+        {
+            std::cerr << "乐谱速度无效: " << path << "\n";
+            skipped++;
+            continue;
+        }
+        jobs.push_back(std::move(job));
+    }
+
+    WorkStealingPool pool(threads);
+    const BatchStats stats = renderBatch(jobs, pool, 48000, format);
+
+    const size_t failed = stats.failed + skipped;
+    std::printf("rendered %zu files (%zu failed, %zu skipped) on %zu threads in %.3f s\n",
+                stats.files, failed, skipped, pool.size(), stats.wallSeconds);
+    std::printf("throughput: %.2f Msamples/s\n", stats.samplesPerSecond() / 1e6);
+    std::printf("latency per file: p50 %.2f ms, p95 %.2f ms, max %.2f ms\n",
+                stats.latencyQuantile(0.5), stats.latencyQuantile(0.95), stats.latencyQuantile(1.0));
+    return failed == 0 ? 0 : 1;
+}
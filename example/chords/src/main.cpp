@@ -0,0 +1,70 @@
+#include "ems_parser.hpp"
+#include "ChordRender.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstdio>
+using namespace ems::literals;
+
+// Chords of 1 to 5 tones (two lane groups), with a rest and notes longer than one block.
+constexpr auto song = "(120)[135],[1`46]-[257]_1,0-[13`57b2`]-[`1`5]."_ems_poly;
+constexpr uint32_t sampleRate = 48000;
+
+static_assert(song.size() == 7 && song[0].ratios.size() == 5);
+
+// The same score as the sum of single-voice generatePCM() renders: every tone of a chord
+// rendered on its own, divided by the number of sounding tones as renderChord() does.
+template <size_t N, size_t V>
+static std::vector<float> mixOfVoices(const std::array<ems::Chord<V>, N>& chords)
+{
+    std::vector<float> mix;
+    std::vector<float> voice;
+    for (const auto& c : chords)
+    {
+        const size_t start = mix.size();
+        mix.resize(start + noteSamples(c.duration_ms, sampleRate) + noteGap(sampleRate), 0.0f);
+
+        size_t active = 0;
+        for (const float r : c.ratios) active += r > 0.0f;
+        for (const float r : c.ratios)
+        {
+            if (r <= 0.0f) continue;
+            generatePCM(std::array{ems::Note{r, c.duration_ms}}, voice, sampleRate);
+            for (size_t i = 0; i < voice.size(); ++i) mix[start + i] += voice[i] / static_cast<float>(active);
+        }
+    }
+    return mix;
+}
+
+// generatePCMPoly() must match the per-voice mix; the phasor bank and std::sin differ
+// only by float rounding.
+int main()
+{
+    std::vector<float> poly;
+    generatePCMPoly(song, poly, sampleRate);
+    const std::vector<float> mix = mixOfVoices(song);
+
+    if (poly.size() != mix.size())
+    {
+        std::fprintf(stderr, "和弦渲染长度不正确: %zu / %zu\n", poly.size(), mix.size());
+        return 1;
+    }
+
+    float worst = 0.0f;
+    double energy = 0.0;
+    for (size_t i = 0; i < mix.size(); ++i)
+    {
+        worst = std::fmax(worst, std::fabs(poly[i] - mix[i]));
+        energy += static_cast<double>(mix[i]) * mix[i];
+    }
+    std::printf("%zu chords, %zu samples, rms %.4f, max difference %.2e\n", song.size(), mix.size(),
+                std::sqrt(energy / static_cast<double>(mix.size())), worst);
+
+    // 电平约 0.2，允许 2.5e-4 的相对误差
+    if (worst > 5e-5f || energy == 0.0)
+    {
+        std::fprintf(stderr, "和弦渲染与单声部之和不一致\n");
+        return 1;
+    }
+    return 0;
+}
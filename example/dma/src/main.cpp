@@ -0,0 +1,116 @@
+#include "ems_parser.hpp"
+#include "ems_fixed.hpp"
+#include "ems_dma.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+using namespace ems::literals;
+
+constexpr uint32_t sampleRate = 16000;
+constexpr size_t halfFrames = 128; // 8 ms per interrupt at 16 kHz
+
+constexpr auto melody = R"((104){4}
+4s,4s,5,6,6,5,4s,3,
+2,2,3,4s,4s-,3-3,,
+4s,4s,5,6,6,5,4s,3,
+2,2,3,4s,3-,2-2,,
+)"_ems;
+
+constexpr auto score = ems::fixed::compile<sampleRate>(melody);
+
+using Synth = ems::fixed::Synth<>;
+using Buffer = ems::dma::DoubleBuffer<Synth, halfFrames>;
+
+/**
+ * Host stand-in for a circular DMA channel: a timer thread "plays" one half every
+ * half-buffer period, copies what the DAC would have output, then fires the matching
+ * interrupt and measures the handler against its budget and deadline (one period).
+ */
+struct SimulatedDma
+{
+    using clock = std::chrono::steady_clock;
+
+    Buffer& buffer;
+    double speed = 1.0;
+
+    std::vector<int16_t> played{};
+    uint32_t interrupts = 0;
+    uint32_t overBudget = 0; // handler itself took longer than a period
+    uint32_t late = 0; // refill finished after its deadline, host scheduling included
+    clock::duration worstIsr{};
+    clock::duration totalIsr{};
+    clock::duration worstJitter{};
+
+    void run()
+    {
+        const auto period = std::chrono::duration_cast<clock::duration>(
+            std::chrono::duration<double>(static_cast<double>(halfFrames) / sampleRate / speed));
+
+        auto due = clock::now();
+        size_t half = 0;
+        while (!buffer.finished())
+        {
+            due += period;
+            std::this_thread::sleep_until(due);
+            const auto fired = clock::now();
+
+            // DMA 已读完这一半：记录 DAC 实际输出的内容
+            const int16_t* src = buffer.data() + half * halfFrames;
+            played.insert(played.end(), src, src + halfFrames);
+
+            if (half == 0) buffer.on_half_transfer();
+            else buffer.on_transfer_complete();
+            const auto done = clock::now();
+
+            interrupts++;
+            worstIsr = std::max(worstIsr, done - fired);
+            totalIsr += done - fired;
+            worstJitter = std::max(worstJitter, fired - due);
+            if (done - fired > period) overBudget++;
+            if (done > due + period) late++;
+            half ^= 1;
+        }
+    }
+};
+
+// Usage: ems_example_dma [speed]   (speed > 1 shortens the interrupt period for a quicker run)
+int main(int argc, char** argv)
+{
+    const double speed = argc > 1 ? std::max(1.0, std::atof(argv[1])) : 8.0;
+
+    // 参考输出：直接渲染整首
+    std::vector<int16_t> expected;
+    {
+        Synth reference(score.data(), score.size(), sampleRate);
+        int16_t block[256];
+        while (const size_t n = reference.render(block, 256)) expected.insert(expected.end(), block, block + n);
+    }
+
+    Synth synth(score.data(), score.size(), sampleRate);
+    Buffer buffer(synth);
+    buffer.prime();
+
+    SimulatedDma dma{buffer, speed};
+    std::thread timer([&] { dma.run(); });
+    timer.join();
+
+    const bool match = dma.played.size() >= expected.size()
+        && std::equal(expected.begin(), expected.end(), dma.played.begin())
+        && std::all_of(dma.played.begin() + static_cast<std::ptrdiff_t>(expected.size()), dma.played.end(),
+                       [](int16_t s) { return s == 0; });
+
+    using us = std::chrono::duration<double, std::micro>;
+    const double periodUs = 1e6 * halfFrames / sampleRate / speed;
+    std::printf("interrupts      %u (period %.0f us)\n", dma.interrupts, periodUs);
+    std::printf("isr worst/avg   %.1f / %.1f us\n", us(dma.worstIsr).count(),
+                us(dma.totalIsr).count() / std::max<uint32_t>(dma.interrupts, 1));
+    std::printf("wakeup jitter   %.1f us worst\n", us(dma.worstJitter).count());
+    std::printf("over budget     %u, overruns %u\n", dma.overBudget, buffer.overruns());
+    std::printf("late refills    %u (includes host scheduler jitter)\n", dma.late);
+    std::printf("output          %s\n", match ? "matches reference" : "MISMATCH");
+    return match && dma.overBudget == 0 && buffer.overruns() == 0 ? 0 : 1;
+}
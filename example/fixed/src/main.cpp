@@ -0,0 +1,65 @@
+#include "ems_parser.hpp"
+#include "ems_fixed.hpp"
+
+#include <cstdio>
+using namespace ems::literals;
+
+constexpr uint32_t sampleRate = 16000;
+
+constexpr auto melody = R"((104){4}
+4s,4s,5,6,6,5,4s,3,
+2,2,3,4s,4s-,3-3,,
+4s,4s,5,6,6,5,4s,3,
+2,2,3,4s,3-,2-2,,
+)"_ems;
+
+constexpr auto score = ems::fixed::compile<sampleRate>(melody);
+
+// Golden values of the render below. The synth is integer-only, so they are the same on
+// every compiler and target; update them only when the synth output changes on purpose.
+constexpr size_t goldenSamples = 295472;
+constexpr uint32_t goldenHash = 0x19481fcf;
+
+// Renders with the integer synth and writes raw little-endian s16 (the golden file),
+// then checks the length and FNV-1a hash of the samples against the golden values.
+// Usage: ems_example_fixed [out.s16]
+int main(int argc, char** argv)
+{
+    const char* path = argc > 1 ? argv[1] : "ode_to_joy.s16";
+    std::FILE* file = std::fopen(path, "wb");
+    if (file == nullptr)
+    {
+        std::fprintf(stderr, "无法打开文件: %s\n", path);
+        return 1;
+    }
+
+    ems::fixed::Synth<> synth(score.data(), score.size(), sampleRate);
+    int16_t block[256];
+    uint8_t bytes[sizeof(block)];
+    uint32_t hash = 2166136261u;
+    size_t total = 0;
+    while (const size_t n = synth.render(block, 256))
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            const auto u = static_cast<uint16_t>(block[i]);
+            bytes[2 * i] = static_cast<uint8_t>(u);
+            bytes[2 * i + 1] = static_cast<uint8_t>(u >> 8);
+        }
+        for (size_t i = 0; i < 2 * n; ++i)
+        {
+            hash = (hash ^ bytes[i]) * 16777619u;
+        }
+        std::fwrite(bytes, 1, 2 * n, file);
+        total += n;
+    }
+    std::fclose(file);
+
+    std::printf("%zu samples @ %u Hz -> %s, fnv1a %08x\n", total, sampleRate, path, hash);
+    if (total != goldenSamples || hash != goldenHash)
+    {
+        std::fprintf(stderr, "输出与黄金值不一致: 应为 %zu 个样本, fnv1a %08x\n", goldenSamples, goldenHash);
+        return 1;
+    }
+    return 0;
+}
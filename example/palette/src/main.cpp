@@ -0,0 +1,55 @@
+#include "ems_parser.hpp"
+#include "ems_palette.hpp"
+
+#include <cstdio>
+using namespace ems::literals;
+
+// example/songs/twinkle_star.ems
+constexpr auto twinkle = R"((120){4}
+1,1,5,5,6,6,5,,
+4,4,3,3,2,2,1,,
+5,5,4,4,3,3,2,,
+5,5,4,4,3,3,2,,
+1,1,5,5,6,6,5,,
+4,4,3,3,2,2,1,,
+)"_ems;
+
+static constexpr auto packed = ems::pack<twinkle>();
+
+// Decoding every note gives back exactly the parsed score.
+template <typename Packed, size_t N>
+constexpr bool roundTrips(const Packed& p, const std::array<ems::Note, N>& notes)
+{
+    if (p.size() != N) return false;
+    size_t i = 0;
+    for (const ems::Note n : p)
+    {
+        if (n.ratio != notes[i].ratio || n.duration_ms != notes[i].duration_ms) return false;
+        i++;
+    }
+    return i == N;
+}
+
+static_assert(roundTrips(packed, twinkle));
+// Six pitches; durations 500 and 1000 ms, plus 0 ms from the "{4}" line, which the parser reads as an empty note.
+static_assert(packed.pitches.size() == 6 && packed.durations.size() == 3);
+static_assert(sizeof(packed) == 80 && sizeof(twinkle) == 344);
+
+// Prints the palettes and the storage saved by packing twinkle_star.ems.
+int main()
+{
+    std::printf("%zu notes, %zu pitches, %zu durations\n", packed.size(), packed.pitches.size(),
+                packed.durations.size());
+    std::printf("pitches:");
+    for (const float r : packed.pitches) std::printf(" %.3f", r);
+    std::printf("\ndurations:");
+    for (const uint32_t d : packed.durations) std::printf(" %u", d);
+    std::printf("\n%zu bytes as ems::Note, %zu bytes packed\n", sizeof(twinkle), sizeof(packed));
+
+    // 运行时再核对一次：迭代器与下标访问一致
+    for (size_t i = 0; i < packed.size(); ++i)
+    {
+        if (packed[i].ratio != twinkle[i].ratio || packed[i].duration_ms != twinkle[i].duration_ms) return 1;
+    }
+    return roundTrips(packed, twinkle) ? 0 : 1;
+}
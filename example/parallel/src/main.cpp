@@ -0,0 +1,62 @@
+#include "ems_parser.hpp"
+#include "ParallelRender.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+using namespace ems::literals;
+
+// example/songs/twinkle_star.ems
+constexpr auto twinkle = R"((120){4}
+1,1,5,5,6,6,5,,
+4,4,3,3,2,2,1,,
+5,5,4,4,3,3,2,,
+5,5,4,4,3,3,2,,
+1,1,5,5,6,6,5,,
+4,4,3,3,2,2,1,,
+)"_ems;
+
+constexpr auto marked = "(150)1,'3,'5>-1`~-1`~-5=.3.1_0,1>,"_ems_art;
+
+// Renders `notes` both ways and compares the bytes; returns false on any difference.
+template <typename Container>
+static bool same(const char* name, const Container& notes, WorkStealingPool& pool, const uint32_t sampleRate,
+                 const Waveform waveform)
+{
+    std::vector<float> serial;
+    std::vector<float> parallel;
+    generatePCM(notes, serial, sampleRate, waveform);
+    generatePCMParallel(notes, parallel, pool, sampleRate, waveform);
+
+    const bool ok = serial.size() == parallel.size() &&
+                    std::memcmp(serial.data(), parallel.data(), serial.size() * sizeof(float)) == 0;
+    std::printf("%-10s %zu threads, %5u Hz: %zu notes, %zu samples %s\n", name, pool.size(), sampleRate,
+                std::size(notes), serial.size(), ok ? "identical" : "DIFFERENT");
+    return ok;
+}
+
+// generatePCMParallel() must be bit-identical to generatePCM() for any pool size,
+// sample rate and waveform, including chunks that split in the middle of a score.
+int main()
+{
+    // 运行时解析的长乐谱，音符数远多于分块数
+    std::string text = "(132)";
+    for (int i = 0; i < 40; ++i) text += "1-3.5.`6,2-4s-6_0.7b,";
+    std::vector<ems::Note> longScore(ems::count_notes(text));
+    longScore.resize(ems::parse(text, longScore.data(), longScore.size()));
+
+    int failed = 0;
+    for (const size_t threads : {1, 2, 3, 8})
+    {
+        WorkStealingPool pool(threads);
+        failed += !same("twinkle", twinkle, pool, 48000, Waveform::Sine);
+        failed += !same("marked", marked, pool, 44100, Waveform::Saw);
+        failed += !same("long", longScore, pool, 22050, Waveform::Square);
+    }
+    if (failed != 0)
+    {
+        std::fprintf(stderr, "并行渲染与顺序渲染不一致: %d 项\n", failed);
+        return 1;
+    }
+    return 0;
+}
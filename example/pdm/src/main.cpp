@@ -0,0 +1,65 @@
+#include "ems_parser.hpp"
+#include "ems_fixed.hpp"
+#include "ems_pdm.hpp"
+
+#include <bit>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+using namespace ems::literals;
+
+constexpr uint32_t sampleRate = 16000;
+constexpr uint32_t oversampling = 64; // 1.024 Mbit/s
+
+constexpr auto melody = R"((104){4}
+4s,4s,5,6,6,5,4s,3,
+2,2,3,4s,4s-,3-3,,
+4s,4s,5,6,6,5,4s,3,
+2,2,3,4s,3-,2-2,,
+)"_ems;
+
+constexpr auto score = ems::fixed::compile<sampleRate>(melody);
+
+// Renders the melody as a PDM bitstream (raw words, MSB first) and checks it: the
+// number of ones emitted so far must track the integrated input to within one bit.
+// Usage: ems_example_pdm [out.pdm]
+int main(int argc, char** argv)
+{
+    const char* path = argc > 1 ? argv[1] : "ode_to_joy.pdm";
+
+    std::vector<int16_t> pcm;
+    {
+        ems::fixed::Synth<> synth(score.data(), score.size(), sampleRate);
+        int16_t block[256];
+        while (const size_t n = synth.render(block, 256)) pcm.insert(pcm.end(), block, block + n);
+    }
+
+    ems::fixed::Synth<> synth(score.data(), score.size(), sampleRate);
+    ems::pdm::Modulator<ems::fixed::Synth<>, oversampling> pdm(synth);
+    std::vector<uint32_t> words;
+    uint32_t block[256];
+    while (const size_t n = pdm.render(block, 256)) words.insert(words.end(), block, block + n);
+
+    if (std::FILE* file = std::fopen(path, "wb"))
+    {
+        std::fwrite(words.data(), sizeof(uint32_t), words.size(), file);
+        std::fclose(file);
+    }
+
+    // 一阶 sigma-delta 的不变量：到任一采样为止输出的 1 的总数，与输入密度的累计值相差不足 1
+    constexpr uint32_t wordsPerSample = oversampling / 32;
+    uint64_t ones = 0;
+    uint64_t density = 0; // Q16
+    double worst = 0.0;
+    for (size_t i = 0; i < pcm.size(); ++i)
+    {
+        for (uint32_t w = 0; w < wordsPerSample; ++w) ones += std::popcount(words[i * wordsPerSample + w]);
+        density += static_cast<uint64_t>(ems::pdm::density(pcm[i])) * oversampling;
+        worst = std::fmax(worst, std::fabs(static_cast<double>(ones) - static_cast<double>(density) / 65536.0));
+    }
+
+    std::printf("%zu samples -> %zu words (%.2f Mbit/s) -> %s\n", pcm.size(), words.size(),
+                sampleRate * oversampling / 1e6, path);
+    std::printf("running bit count deviates from the input by at most %.3f bits\n", worst);
+    return words.size() == pcm.size() * wordsPerSample && worst < 1.0 ? 0 : 1;
+}
@@ -0,0 +1,198 @@
+#include "ems_parser.hpp"
+#include "Player.hpp"
+#include "Audio.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <span>
+#include <thread>
+#include <vector>
+using namespace ems::literals;
+
+constexpr auto intro = "(240)1,3,5,"_ems;
+constexpr auto loop = "(240)1`,5,3,1,"_ems;
+constexpr uint32_t block = 512;
+
+// Renders until the player is idle, the way the device callback would.
+template <typename P>
+static std::vector<float> drain(P& player)
+{
+    std::vector<float> out;
+    float buf[block];
+    while (!player.idle())
+    {
+        player.render(buf, block);
+        out.insert(out.end(), buf, buf + block);
+    }
+    return out;
+}
+
+// Two queued melodies must come out exactly as generatePCM() renders them back to back.
+static bool checkGapless()
+{
+    Player<> player; // 不打开设备，离线渲染
+    player.enqueue(intro);
+    player.enqueue(loop);
+    const std::vector<float> out = drain(player);
+
+    std::vector<float> expected;
+    std::vector<float> second;
+    generatePCM(intro, expected, player.sampleRate());
+    generatePCM(loop, second, player.sampleRate());
+    expected.insert(expected.end(), second.begin(), second.end());
+
+    float diff = 0.0f;
+    for (size_t i = 0; i < expected.size(); ++i) diff = std::max(diff, std::fabs(out[i] - expected[i]));
+    float tail = 0.0f;
+    for (size_t i = expected.size(); i < out.size(); ++i) tail = std::max(tail, std::fabs(out[i]));
+
+    std::printf("gapless: %zu frames expected, max diff %g, tail %g\n", expected.size(), diff, tail);
+    return out.size() >= expected.size() && diff < 1e-5f && tail == 0.0f;
+}
+
+constexpr auto tone = "(60)6_"_ems; // 2 s of A4
+
+struct Measure
+{
+    double rms;
+    double hz;
+};
+
+// Level and zero-crossing frequency of `tone` after the controls were applied, skipping the first block (ramp).
+static Measure measureTone(void (*setup)(LiveControl&))
+{
+    Player<> player;
+    setup(player.controls());
+    player.enqueue(tone);
+    const std::vector<float> out = drain(player);
+
+    const size_t from = block;
+    const size_t to = player.sampleRate(); // 第一秒，包络已稳定
+    double sum = 0.0;
+    size_t crossings = 0;
+    for (size_t i = from; i < to; ++i)
+    {
+        sum += static_cast<double>(out[i]) * out[i];
+        crossings += (out[i - 1] < 0.0f) != (out[i] < 0.0f);
+    }
+    const double seconds = static_cast<double>(to - from) / player.sampleRate();
+    return Measure{std::sqrt(sum / static_cast<double>(to - from)), crossings / 2.0 / seconds};
+}
+
+// Each control must audibly change what the callback renders.
+static bool checkControls()
+{
+    const Measure plain = measureTone([](LiveControl&) {});
+    const Measure octave = measureTone([](LiveControl& c) { c.setTranspose(12.0f); });
+    const Measure quiet = measureTone([](LiveControl& c) { c.setVolume(0.5f); });
+    const Measure square = measureTone([](LiveControl& c) { c.setWaveform(Waveform::Square); });
+
+    std::printf("controls: plain %.0f Hz rms %.4f, +12 st %.0f Hz, volume 0.5 rms %.4f, square rms %.4f\n", plain.hz,
+                plain.rms, octave.hz, quiet.rms, square.rms);
+    return std::fabs(plain.hz - 440.0) < 5.0 && std::fabs(octave.hz - 880.0) < 10.0 &&
+           std::fabs(quiet.rms / plain.rms - 0.5) < 0.01 && square.rms > plain.rms * 1.3;
+}
+
+// Note-on frames must follow the rendered layout (note + 1 ms gap), each note must be switched
+// off before the next one starts, and a transpose made mid-melody must change what is heard.
+static bool checkEvents()
+{
+    Player<> player;
+    player.enqueue(intro);
+    player.enqueue(loop);
+
+    std::vector<float> out;
+    float buf[block];
+    const uint32_t rate = player.sampleRate();
+    const size_t half = noteSamples(1000, rate); // intro 结束后再移调
+    while (!player.idle())
+    {
+        if (out.size() == half / block * block) player.controls().setTranspose(12.0f);
+        player.render(buf, block);
+        out.insert(out.end(), buf, buf + block);
+    }
+
+    std::vector<NoteEvent> events;
+    for (NoteEvent e; player.events().pop(e);) events.push_back(e);
+
+    bool ok = player.droppedEvents() == 0 && events.size() == 2 * (intro.size() + loop.size());
+    uint64_t expected = 0;
+    size_t at = 0;
+    for (uint32_t melody = 0; melody < 2 && ok; ++melody)
+    {
+        const auto& notes = melody == 0 ? std::span<const ems::Note>(intro) : std::span<const ems::Note>(loop);
+        for (uint32_t i = 0; i < notes.size() && ok; ++i)
+        {
+            const NoteEvent& on = events[at++];
+            const NoteEvent& off = events[at++];
+            ok = on.edge == NoteEdge::On && off.edge == NoteEdge::Off && on.melody == melody && off.melody == melody &&
+                 on.note == i && off.note == i && on.frame == expected && off.frame > on.frame &&
+                 off.frame <= expected + noteSamples(notes[i].duration_ms, rate) && on.ratio == notes[i].ratio;
+            expected += noteSamples(notes[i].duration_ms, rate) + noteGap(rate);
+        }
+    }
+
+    // loop 的最后一个音（1，即 C4）移调后应在 C5 附近
+    const uint64_t lastOn = events[events.size() - 2].frame;
+    const size_t from = lastOn + block;
+    const size_t to = lastOn + noteSamples(loop.back().duration_ms, rate) - block;
+    size_t crossings = 0;
+    for (size_t i = from; i < to; ++i) crossings += (out[i - 1] < 0.0f) != (out[i] < 0.0f);
+    const double hz = crossings / 2.0 / (static_cast<double>(to - from) / rate);
+    const double c5 = 440.0 * loop.back().ratio * 2.0;
+
+    std::printf("events: %zu in order %s, last note %.0f Hz (expected %.0f)\n", events.size(), ok ? "yes" : "no", hz,
+                c5);
+    return ok && std::fabs(hz - c5) < 10.0;
+}
+
+// Usage: ems_example_player [offline]
+int main(int argc, char** argv)
+{
+    if (!checkGapless() || !checkControls() || !checkEvents())
+    {
+        std::fprintf(stderr, "离线检查失败\n");
+        return 1;
+    }
+    if (argc > 1 && std::strcmp(argv[1], "offline") == 0) return 0;
+
+    Player<> player;
+    if (player.open() != 0) return 1;
+
+    // 设备保持运行，之后每次播放只是一次入队
+    for (int i = 0; i < 3; ++i)
+    {
+        const auto t0 = std::chrono::steady_clock::now();
+        player.enqueue(intro);
+        player.enqueue(loop, Waveform::Triangle);
+        while (!player.idle())
+        {
+            // 按事件到达扬声器的时间打印，相当于驱动 LED
+            for (NoteEvent e; player.events().pop(e);)
+            {
+                if (e.edge != NoteEdge::On) continue;
+                std::this_thread::sleep_until(player.clock().toSteady(e.frame));
+                std::printf("  note %u.%u\n", e.melody, e.note);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        const auto ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        std::printf("round %d: %.0f ms\n", i, ms);
+    }
+
+    // 播放中从另一个线程调整：移调、音量、音色，下一个回调块内生效
+    player.enqueue(loop);
+    player.enqueue(loop);
+    std::thread knob([&]
+    {
+        player.controls().setTranspose(5.0f);
+        std::this_thread::sleep_for(std::chrono::milliseconds(400));
+        player.controls().setVolume(0.4f);
+        player.controls().setWaveform(Waveform::Square);
+    });
+    knob.join();
+    while (!player.idle()) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    return 0;
+}
@@ -0,0 +1,56 @@
+#include "ems_parser.hpp"
+#include "ems_pwm.hpp"
+
+#include <cmath>
+#include <cstdio>
+using namespace ems::literals;
+
+constexpr uint32_t timerClock = 72'000'000; // e.g. STM32F1 APB1 timer clock
+
+constexpr auto melody = R"((104){4}
+4s,4s,5,6,6,5,4s,3,
+2,2,3,4s,4s-,3-3,,
+4s,4s,5,6,6,5,4s,3,
+2,2,3,4s,3-,2-2,,
+)"_ems;
+
+constexpr auto steps = ems::pwm::schedule(melody, timerClock);
+
+// Prints the generated register table with each note's pitch error, then runs the
+// sequencer the way the update interrupt would and checks the total duration.
+int main()
+{
+    std::printf(" #   PSC    ARR    CCR   ticks  target Hz   actual Hz   cents\n");
+    double worstCents = 0.0;
+    uint32_t songMs = 0;
+    for (size_t i = 0; i < steps.size(); ++i)
+    {
+        const auto& s = steps[i];
+        const double target = 440.0 * melody[i].ratio;
+        const double actual = ems::pwm::frequency(s, timerClock);
+        const double cents = s.compare == 0 ? 0.0 : 1200.0 * std::log2(actual / target);
+        worstCents = std::fmax(worstCents, std::fabs(cents));
+        songMs += melody[i].duration_ms;
+        std::printf("%2zu %5u %6u %6u %7u %10.3f %11.3f %7.4f\n", i, s.prescaler, s.auto_reload, s.compare,
+                    s.duration_ticks, target, actual, cents);
+    }
+
+    // 模拟定时器更新中断
+    ems::pwm::ToneSequencer seq(steps.data(), steps.size());
+    const ems::pwm::Step* current = seq.start();
+    double playedMs = 0.0;
+    uint32_t writes = 1;
+    while (!seq.finished())
+    {
+        playedMs += 1000.0 / ems::pwm::frequency(*current, timerClock);
+        if (const auto* next = seq.on_update())
+        {
+            current = next;
+            writes++;
+        }
+    }
+
+    std::printf("worst pitch error %.4f cents, %u register updates\n", worstCents, writes);
+    std::printf("duration %.1f ms (score %u ms)\n", playedMs, songMs);
+    return 0;
+}
@@ -0,0 +1,50 @@
+#include "ems_parser.hpp"
+#include "ems_fixed.hpp"
+#include "ems_render.hpp"
+
+#include <cstdio>
+#include <vector>
+using namespace ems::literals;
+
+constexpr auto click = "(600)5`.3`."_ems;
+constexpr auto chirp = "(480)1`,3`,5`,1``,"_ems;
+
+// Both end up in .rodata; nothing is synthesised at run time to play them.
+static constexpr auto clickPcm = ems::render<8000, int8_t, click>();
+static constexpr auto chirpPcm = ems::render<16000, int16_t, chirp>();
+
+static_assert(clickPcm.size() == 416 && clickPcm.size() == ems::rendered_samples<8000>(click));
+static_assert(chirpPcm.size() == ems::rendered_samples<16000>(chirp));
+
+// The same score rendered at run time by the integer synth.
+template <size_t N>
+static std::vector<int16_t> runtimeRender(const std::array<ems::fixed::Note, N>& score, const uint32_t rate)
+{
+    ems::fixed::Synth<> synth(score.data(), score.size(), rate);
+    std::vector<int16_t> pcm;
+    int16_t block[64];
+    while (const size_t n = synth.render(block, 64)) pcm.insert(pcm.end(), block, block + n);
+    return pcm;
+}
+
+// Checks the ROM arrays against the runtime synth: int16 bit-identical, int8 the rounded int16.
+int main()
+{
+    const std::vector<int16_t> chirpRef = runtimeRender(ems::fixed::compile<16000>(chirp), 16000);
+    bool same16 = chirpRef.size() == chirpPcm.size();
+    for (size_t i = 0; same16 && i < chirpRef.size(); ++i) same16 = chirpRef[i] == chirpPcm[i];
+
+    const std::vector<int16_t> clickRef = runtimeRender(ems::fixed::compile<8000>(click), 8000);
+    bool same8 = clickRef.size() == clickPcm.size();
+    for (size_t i = 0; same8 && i < clickRef.size(); ++i)
+    {
+        const int32_t v = (clickRef[i] + 128) >> 8; // 与 render() 相同的舍入
+        same8 = clickPcm[i] == static_cast<int8_t>(v > 127 ? 127 : v);
+    }
+
+    std::printf("click: %zu int8 samples (%zu bytes), matches runtime synth: %s\n", clickPcm.size(), sizeof(clickPcm),
+                same8 ? "yes" : "no");
+    std::printf("chirp: %zu int16 samples (%zu bytes), bit-identical to runtime synth: %s\n", chirpPcm.size(),
+                sizeof(chirpPcm), same16 ? "yes" : "no");
+    return same8 && same16 ? 0 : 1;
+}
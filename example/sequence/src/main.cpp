@@ -0,0 +1,45 @@
+#include "ems_parser.hpp"
+#include "Sequence.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+using namespace ems::literals;
+
+constexpr auto melody = "(120)1,1,5,5,6,6,5,,4,4,3,3,2,2,1,,"_ems;
+constexpr auto chime = "(240)5`,3`,1`,"_ems;
+
+SeqTask lights(SequencePlayer<>& player)
+{
+    const auto song = player.start(melody);
+    for (size_t i = 0; i < melody.size(); ++i)
+    {
+        co_await song.until_note(i);
+        std::cout << "LED " << i << " @ frame " << player.now() << "\n";
+    }
+}
+
+SeqTask alerts(SequencePlayer<>& player)
+{
+    for (int i = 0; i < 3; ++i)
+    {
+        co_await player.delay_ms(1500);
+        co_await player.play(chime);
+        std::cout << "haptic pulse\n";
+    }
+}
+
+int main()
+{
+    SequencePlayer<> player;
+    if (player.open() != 0) return 1;
+
+    player.spawn(lights(player));
+    player.spawn(alerts(player));
+
+    while (!player.idle())
+    {
+        player.poll();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
@@ -0,0 +1,45 @@
+#include "ems_parser.hpp"
+#include "Mixer.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+using namespace ems::literals;
+
+constexpr auto click = "(600)5`."_ems;
+constexpr auto alert = "(300)5`,3`,5`,3`,"_ems;
+constexpr auto theme = "(120)1,1,5,5,6,6,5,,"_ems;
+
+int main()
+{
+    SfxMixer<> mixer;
+    if (mixer.open() != 0) return 1;
+
+    mixer.play(theme, 0, 0.8f, Waveform::Triangle);
+
+    // UI 线程与游戏线程同时触发音效
+    std::thread ui([&]
+    {
+        for (int i = 0; i < 40; ++i)
+        {
+            mixer.play(click, 1, 0.5f, Waveform::Square);
+            std::this_thread::sleep_for(std::chrono::milliseconds(90));
+        }
+    });
+    std::thread game([&]
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+            mixer.play(alert, 2);
+        }
+    });
+    ui.join();
+    game.join();
+
+    while (mixer.activeVoices() > 0)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    std::cout << "done\n";
+}
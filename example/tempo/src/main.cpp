@@ -0,0 +1,81 @@
+#include "ems_parser.hpp"
+#include "TickStream.hpp"
+#include "WavWriter.hpp"
+
+#include <cstdio>
+#include <vector>
+using namespace ems::literals;
+
+constexpr auto song = "(120)1,2,3,4,5,6,7,"_ems_ticks; // 7 beats, 3.5 s at 120 BPM
+constexpr uint32_t sampleRate = 48000;
+
+// Plays 10 ms at the score tempo, switches to `bpm`, and returns the frame at which each note ends.
+// Every note ends with a 1 ms run of exact zeros (the gap), which is where the notes are split.
+static std::vector<size_t> noteEnds(const float bpm)
+{
+    TickStream<decltype(song)> stream(song, sampleRate);
+    std::vector<float> out(480);
+    stream.read(out.data(), out.size());
+    stream.setTempo(bpm);
+    float block[480];
+    while (const size_t n = stream.read(block, 480)) out.insert(out.end(), block, block + n);
+
+    // 下一个音符的第一个样本也是 0，所以从零段的起点算起
+    std::vector<size_t> ends;
+    size_t zeros = 0;
+    for (size_t i = 0; i <= out.size(); ++i)
+    {
+        if (i < out.size() && out[i] == 0.0f)
+        {
+            zeros++;
+            continue;
+        }
+        if (zeros >= noteGap(sampleRate)) ends.push_back(i - zeros + noteGap(sampleRate));
+        zeros = 0;
+    }
+    return ends;
+}
+
+// Usage: ems_example_tempo [out.wav]
+int main(int argc, char** argv)
+{
+    // 第一拍剩余的 0.98 拍按新速度演奏，之后每拍都在节拍网格上结束，一个音符也不丢
+    for (const float bpm : {120.0f, 480.0f, 60.0f})
+    {
+        const size_t beat = sampleRate * 60 / static_cast<size_t>(bpm);
+        const size_t first = 480 + static_cast<size_t>(0.98 * static_cast<double>(beat));
+        std::vector<size_t> expected;
+        for (size_t i = 0; i < song.size(); ++i) expected.push_back(first + i * beat);
+
+        const std::vector<size_t> ends = noteEnds(bpm);
+        std::printf("120 -> %3.0f BPM after 10 ms: %zu notes, last ends at %zu (expected %zu notes, %zu)\n", bpm,
+                    ends.size(), ends.empty() ? 0 : ends.back(), expected.size(), expected.back());
+        if (ends != expected)
+        {
+            std::fprintf(stderr, "速度变化后音符边界不正确\n");
+            return 1;
+        }
+    }
+
+    // 循环播放，四秒内加速到 180 BPM
+    const char* path = argc > 1 ? argv[1] : "tempo.wav";
+    WavWriter writer;
+    if (!writer.open(path, sampleRate, 1, SampleFormat::F32))
+    {
+        std::fprintf(stderr, "WAV 文件打开失败: %s\n", path);
+        return 1;
+    }
+    TickStream<decltype(song)> stream(song, sampleRate, Waveform::Triangle, {}, true);
+    stream.rampTempo(180.0f, 4000);
+    float block[1024];
+    for (uint32_t written = 0; written < sampleRate * 8; written += 1024)
+    {
+        stream.read(block, 1024);
+        if (!writer.write(block, 1024))
+        {
+            std::fprintf(stderr, "WAV 文件写入失败: %s\n", path);
+            return 1;
+        }
+    }
+    return writer.close() ? 0 : 1;
+}
@@ -0,0 +1,102 @@
+#include "ems_parser.hpp"
+#include "ems_sequencer.hpp"
+
+#include <cstdio>
+#include <vector>
+using namespace ems::literals;
+
+constexpr auto phrase = R"((104){4}
+4s,4s,5,6,6,5,4s,3,
+2,2,3,4s,4s-,3-3,,
+4s,4s,5,6,6,5,4s,3,
+2,2,3,4s,3-,2-2,,
+)"_ems;
+
+// Rough MCU power model (assumed figures, adjust for the target).
+constexpr double sleepMicroAmps = 2.0; // deep sleep, RTC running
+constexpr double activeMilliAmps = 4.0; // CPU awake
+constexpr double wakeupMicroSeconds = 30.0; // wake, handle the event, go back to sleep
+
+struct Run
+{
+    uint64_t wakeups = 0;
+    uint64_t boundaries = 0;
+    uint64_t deadlineErrors = 0; // next_deadline() 与实际边界不符的次数
+    std::vector<uint32_t> timeline; // 每个音符边界的时刻，两种模式必须一致
+};
+
+// Periodic 1 kHz tick: the CPU wakes every millisecond whether or not a note changes.
+static Run periodic(ems::Sequencer<>& seq)
+{
+    Run run;
+    seq.start();
+    while (!seq.finished())
+    {
+        run.wakeups++;
+        const uint32_t due = seq.next_deadline();
+        if (seq.tick())
+        {
+            run.boundaries++;
+            run.timeline.push_back(seq.now());
+            run.deadlineErrors += seq.now() != due;
+        }
+        else
+        {
+            run.deadlineErrors += seq.next_deadline() != due; // 音符内部保持不变
+        }
+    }
+    return run;
+}
+
+// Tickless: one RTC alarm per note boundary, deep sleep in between.
+static Run tickless(ems::Sequencer<>& seq, uint32_t rtcStart)
+{
+    Run run;
+    uint32_t rtc = rtcStart;
+    seq.start(rtc);
+    while (!seq.finished())
+    {
+        rtc = seq.next_deadline(); // 睡到闹钟时刻
+        run.wakeups++;
+        if (seq.advance_to(rtc))
+        {
+            run.boundaries++;
+            run.timeline.push_back(rtc - rtcStart);
+        }
+    }
+    return run;
+}
+
+static void report(const char* name, const Run& run, double seconds)
+{
+    const double awake = static_cast<double>(run.wakeups) * wakeupMicroSeconds * 1e-6;
+    const double charge = awake * activeMilliAmps * 1000.0 + (seconds - awake) * sleepMicroAmps; // uA*s
+    std::printf("%-9s %8llu wakeups  %6llu boundaries  avg %7.2f uA\n", name,
+                static_cast<unsigned long long>(run.wakeups), static_cast<unsigned long long>(run.boundaries),
+                charge / seconds);
+}
+
+int main()
+{
+    // 循环十遍，约三分钟
+    std::vector<ems::Note> song;
+    for (int i = 0; i < 10; ++i) song.insert(song.end(), phrase.begin(), phrase.end());
+
+    uint64_t totalMs = 0;
+    for (const auto& n : song) totalMs += n.duration_ms;
+    const double seconds = static_cast<double>(totalMs) / 1000.0;
+    std::printf("%zu notes, %.1f s\n", song.size(), seconds);
+
+    ems::Sequencer<> a(song.data(), song.size());
+    ems::Sequencer<> b(song.data(), song.size());
+    const Run tick = periodic(a);
+    const Run idle = tickless(b, 0xFFFF0000u); // RTC 计数器在播放中途回绕
+
+    report("periodic", tick, seconds);
+    report("tickless", idle, seconds);
+
+    const bool same = tick.timeline == idle.timeline;
+    std::printf("note boundaries %s, %llu deadline errors\n", same ? "identical" : "DIFFER",
+                static_cast<unsigned long long>(tick.deadlineErrors));
+    return same && tick.deadlineErrors == 0 ? 0 : 1;
+}
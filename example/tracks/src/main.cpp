@@ -0,0 +1,73 @@
+#include "ems_parser.hpp"
+#include "ems_timeline.hpp"
+#include "TrackRender.hpp"
+#include "WavWriter.hpp"
+
+#include <cmath>
+#include <cstdio>
+using namespace ems::literals;
+
+constexpr auto melody = "(120)3,3,4,5,5,4,3,2,1,1,2,3,3.2-2_"_ems;
+constexpr auto bass = "(120)`1_`5_`1_`5_"_ems;
+constexpr auto song = ems::tracks(melody, bass);
+
+// Sorted by start time, ties in track order, and every source note present exactly once.
+template <size_t N>
+constexpr bool mergedInOrder(const std::array<ems::Event, N>& events)
+{
+    for (size_t i = 1; i < N; ++i)
+    {
+        const auto& a = events[i - 1];
+        const auto& b = events[i];
+        if (a.start_ms > b.start_ms || (a.start_ms == b.start_ms && a.track > b.track)) return false;
+    }
+    size_t perTrack[2]{};
+    for (const auto& e : events) perTrack[e.track]++;
+    return perTrack[0] == melody.size() && perTrack[1] == bass.size();
+}
+
+static_assert(song.size() == melody.size() + bass.size());
+static_assert(mergedInOrder(song));
+static_assert(song[0].start_ms == 0 && song[0].track == 0 && song[1].start_ms == 0 && song[1].track == 1);
+
+// Usage: ems_example_tracks [out.wav]
+int main(int argc, char** argv)
+{
+    const char* path = argc > 1 ? argv[1] : "tracks.wav";
+    constexpr uint32_t sampleRate = 48000;
+
+    for (const auto& e : song)
+    {
+        std::printf("%6u ms  track %u  ratio %.3f  %u ms\n", e.start_ms, e.track, e.ratio, e.duration_ms);
+    }
+
+    std::vector<float> pcm;
+    generatePCMTracks(song, pcm, sampleRate);
+
+    // 两个声部同时发声时的电平应高于单独的旋律
+    std::vector<float> lead;
+    generatePCMTracks(ems::tracks(melody), lead, sampleRate);
+    double both = 0.0;
+    double alone = 0.0;
+    for (size_t i = 0; i < lead.size(); ++i)
+    {
+        both += static_cast<double>(pcm[i]) * pcm[i];
+        alone += static_cast<double>(lead[i]) * lead[i];
+    }
+    std::printf("length %u ms (%zu samples), rms %.4f (melody alone %.4f)\n", ems::length_ms(song), pcm.size(),
+                std::sqrt(both / static_cast<double>(lead.size())), std::sqrt(alone / static_cast<double>(lead.size())));
+    if (pcm.size() != noteSamples(ems::length_ms(song), sampleRate) || both <= alone)
+    {
+        std::fprintf(stderr, "多声部渲染结果不正确\n");
+        return 1;
+    }
+
+    WavWriter writer;
+    if (!writer.open(path, sampleRate, 1, SampleFormat::F32) || !writer.write(pcm.data(), pcm.size()) ||
+        !writer.close())
+    {
+        std::fprintf(stderr, "WAV 文件写入失败: %s\n", path);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,55 @@
+#include "ems_parser.hpp"
+#include "WavWriter.hpp"
+
+#include <cstring>
+#include <iterator>
+#include <vector>
+using namespace ems::literals;
+
+constexpr auto melody = R"((104){4}
+4s,4s,5,6,6,5,4s,3,
+2,2,3,4s,4s-,3-3,,
+4s,4s,5,6,6,5,4s,3,
+2,2,3,4s,3-,2-2,,
+)"_ems;
+
+// seek(t) followed by read() must continue at sample t * rate of the full render.
+template <uint32_t Rate>
+static bool checkSeek()
+{
+    constexpr auto index = ems::time_index<Rate>(melody);
+    std::vector<float> full;
+    generatePCM(melody, full, Rate, Waveform::Triangle);
+    if (full.size() != index.back()) return false;
+
+    PcmStream stream(melody, Rate, Waveform::Triangle);
+    for (const uint32_t ms : {0u, 1000u, 2999u, 7777u, 60'000u / 104 * 9, ems::time_index(melody).back() - 2})
+    {
+        const uint32_t frame = noteSamples(ms, Rate);
+        stream.seek(ems::seek(index, frame));
+        float block[256];
+        const size_t n = stream.read(block, std::size(block));
+        if (n != std::min<size_t>(std::size(block), full.size() - frame)) return false;
+        if (std::memcmp(block, full.data() + frame, n * sizeof(float)) != 0) return false;
+    }
+    return true;
+}
+
+// Usage: ems_example_wav out.wav [s16] [direct]
+int main(int argc, char** argv)
+{
+    const char* path = argc > 1 ? argv[1] : "ode_to_joy.wav";
+    SampleFormat format = SampleFormat::F32;
+    bool direct = false;
+    for (int i = 2; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "s16") == 0) format = SampleFormat::S16;
+        if (std::strcmp(argv[i], "direct") == 0) direct = true;
+    }
+    if (!checkSeek<48000>() || !checkSeek<44100>())
+    {
+        std::cerr << "seek 位置与完整渲染不一致\n";
+        return 1;
+    }
+    return renderToWav(melody, path, 48000, format, Waveform::Triangle, {}, direct);
+}
@@ -0,0 +1,72 @@
+#include "ems_parser.hpp"
+#include "Audio.hpp"
+
+#include <cmath>
+#include <cstdio>
+using namespace ems::literals;
+
+constexpr auto melody = "(120)1,5,3`-0-1`,"_ems;
+constexpr uint32_t sampleRate = 48000;
+
+constexpr Waveform shapes[] = {Waveform::Sine, Waveform::Square, Waveform::Saw, Waveform::Triangle};
+constexpr const char* names[] = {"sine", "square", "saw", "triangle"};
+
+// Largest absolute difference between two equally long buffers.
+static float maxDiff(const std::vector<float>& a, const std::vector<float>& b)
+{
+    float diff = 0.0f;
+    for (size_t i = 0; i < a.size(); ++i) diff = std::fmax(diff, std::fabs(a[i] - b[i]));
+    return diff;
+}
+
+static double rms(const std::vector<float>& v)
+{
+    double sum = 0.0;
+    for (const float x : v) sum += static_cast<double>(x) * x;
+    return std::sqrt(sum / static_cast<double>(v.size()));
+}
+
+// Renders the same note and the same melody with every waveform; each shape must
+// produce its own output (and its own RMS: 1/sqrt(2), 1, 1/sqrt(3), 1/sqrt(3) at full scale).
+int main()
+{
+    constexpr size_t count = sampleRate / 10;
+    constexpr double freq = 440.0;
+    constexpr double expectedRms[] = {0.7071, 1.0, 0.5774, 0.5774};
+
+    std::vector<float> raw[4];
+    std::vector<float> pcm[4];
+    int failed = 0;
+    for (size_t w = 0; w < 4; ++w)
+    {
+        raw[w].resize(count);
+        osc::renderWave(shapes[w], raw[w].data(), count, freq, sampleRate);
+        generatePCM(melody, pcm[w], sampleRate, shapes[w]);
+
+        // PolyBLEP 只修正不连续点附近的样本，RMS 与理想波形相差很小
+        const double r = rms(raw[w]);
+        std::printf("%-8s rms %.4f (expected %.4f), pcm rms %.4f\n", names[w], r, expectedRms[w], rms(pcm[w]));
+        if (std::fabs(r - expectedRms[w]) > 0.02)
+        {
+            std::fprintf(stderr, "%s 波形的 RMS 不正确\n", names[w]);
+            failed++;
+        }
+    }
+
+    for (size_t a = 0; a < 4; ++a)
+    {
+        for (size_t b = a + 1; b < 4; ++b)
+        {
+            const float wave = maxDiff(raw[a], raw[b]);
+            const float song = pcm[a].size() == pcm[b].size() ? maxDiff(pcm[a], pcm[b]) : 1.0f;
+            std::printf("%-8s vs %-8s  max diff %.3f, pcm %.3f\n", names[a], names[b], wave, song);
+            // 归一化波形之间至少相差 0.1，乘以 0.2 的音量后仍应可见
+            if (wave < 0.1f || song < 0.02f)
+            {
+                std::fprintf(stderr, "%s 与 %s 的输出相同\n", names[a], names[b]);
+                failed++;
+            }
+        }
+    }
+    return failed == 0 ? 0 : 1;
+}
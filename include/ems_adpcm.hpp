@@ -0,0 +1,196 @@
+/**
+ * @file ems_adpcm.hpp
+ * @brief Compile-time IMA-ADPCM encoding and a streaming decoder
+ * @license ISC License
+ *
+ * 4-bit IMA-ADPCM stores a rendered melody in a quarter of the int16 size. The
+ * encoder runs at compile time over ems::render() output; the decoder is a table
+ * lookup, a few shifts and adds and a clamp per sample, cheap enough for a DMA
+ * refill interrupt on the smallest Cortex-M parts. Decoder has the same
+ * render(int16_t*, count) interface as ems::fixed::Synth, so it plugs straight
+ * into ems::dma::DoubleBuffer or ems::pdm::Modulator.
+ *
+ * Usage:
+ *   #include "ems_adpcm.hpp"
+ *   using namespace ems::literals;
+ *
+ *   constexpr auto melody = "(120)1,2,3,"_ems;
+ *   static constexpr auto clip = ems::adpcm::render<16000, melody>(); // 2 samples per byte
+ *
+ *   ems::adpcm::Decoder dec(clip);
+ *   ems::dma::DoubleBuffer<ems::adpcm::Decoder, 128> out(dec);
+ *
+ * Nibbles are packed low nibble first, as in IMA ADPCM WAV files. Encoder and decoder
+ * both start from predictor 0, step index 0 (rendered sounds start from silence), so
+ * no block headers are stored.
+ */
+
+#ifndef EMS_ADPCM_HPP
+#define EMS_ADPCM_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "ems_render.hpp"
+
+namespace ems::adpcm
+{
+    inline constexpr std::array<int16_t, 89> step_table = {
+        7,     8,     9,     10,    11,    12,    13,    14,    16,    17,    19,    21,    23,    25,    28,
+        31,    34,    37,    41,    45,    50,    55,    60,    66,    73,    80,    88,    97,    107,   118,
+        130,   143,   157,   173,   190,   209,   230,   253,   279,   307,   337,   371,   408,   449,   494,
+        544,   598,   658,   724,   796,   876,   963,   1060,  1166,  1282,  1411,  1552,  1707,  1878,  2066,
+        2272,  2499,  2749,  3024,  3327,  3660,  4026,  4428,  4871,  5358,  5894,  6484,  7132,  7845,  8630,
+        9493,  10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767};
+
+    inline constexpr std::array<int8_t, 8> index_table = {-1, -1, -1, -1, 2, 4, 6, 8};
+
+    /**
+     * @brief Predictor state shared by encoder and decoder.
+     */
+    struct State
+    {
+        int32_t predictor = 0;
+        int32_t index = 0;
+    };
+
+    /**
+     * @brief Decodes one 4-bit code and advances the state.
+     */
+    constexpr int16_t decode_sample(const uint8_t code, State& state)
+    {
+        const int32_t step = step_table[state.index];
+
+        // step * (code & 7) / 4 + step / 8，与参考实现的移位近似一致
+        int32_t diff = step >> 3;
+        if (code & 4) diff += step;
+        if (code & 2) diff += step >> 1;
+        if (code & 1) diff += step >> 2;
+
+        int32_t p = (code & 8) ? state.predictor - diff : state.predictor + diff;
+        p = p > 32767 ? 32767 : (p < -32768 ? -32768 : p);
+        state.predictor = p;
+
+        const int32_t i = state.index + index_table[code & 7];
+        state.index = i < 0 ? 0 : (i > 88 ? 88 : i);
+        return static_cast<int16_t>(p);
+    }
+
+    /**
+     * @brief Encodes one sample and advances the state.
+     *
+     * The state is advanced with decode_sample() itself, so the encoder tracks exactly
+     * what the decoder will reconstruct and errors do not accumulate.
+     */
+    constexpr uint8_t encode_sample(const int16_t sample, State& state)
+    {
+        const int32_t step = step_table[state.index];
+        int32_t diff = sample - state.predictor;
+
+        uint8_t code = 0;
+        if (diff < 0)
+        {
+            code = 8;
+            diff = -diff;
+        }
+        if (diff >= step)
+        {
+            code |= 4;
+            diff -= step;
+        }
+        if (diff >= step >> 1)
+        {
+            code |= 2;
+            diff -= step >> 1;
+        }
+        if (diff >= step >> 2) code |= 1;
+
+        decode_sample(code, state);
+        return code;
+    }
+
+    /**
+     * @brief An encoded sound: `Samples` samples packed two per byte.
+     */
+    template <size_t Samples>
+    struct Clip
+    {
+        static constexpr size_t samples = Samples;
+        std::array<uint8_t, (Samples + 1) / 2> data;
+    };
+
+    /**
+     * @brief Encodes int16 PCM (e.g. ems::render<Rate, int16_t, Melody>()) at compile time.
+     */
+    template <size_t N>
+    consteval Clip<N> encode(const std::array<int16_t, N>& pcm)
+    {
+        Clip<N> clip{};
+        State state;
+        for (size_t i = 0; i < N; ++i)
+        {
+            const uint8_t code = encode_sample(pcm[i], state);
+            clip.data[i / 2] |= static_cast<uint8_t>(i % 2 == 0 ? code : code << 4);
+        }
+        return clip;
+    }
+
+    /**
+     * @brief Renders and encodes `Melody` at compile time.
+     * @tparam MaxBytes ROM budget of the encoded clip; exceeding it is a compile error.
+     */
+    template <uint32_t SampleRate, auto Melody, size_t MaxBytes = max_render_bytes>
+    consteval auto render()
+    {
+        // 中间的 int16 数据只存在于编译期，按编码后的大小计算预算
+        return encode(ems::render<SampleRate, int16_t, Melody, MaxBytes * 4>());
+    }
+
+    /**
+     * @brief Streams a Clip back to int16 PCM.
+     */
+    class Decoder
+    {
+    public:
+        constexpr Decoder(const uint8_t* data, const size_t samples) : data(data), samples(samples)
+        {
+        }
+
+        template <size_t N>
+        constexpr explicit Decoder(const Clip<N>& clip) : Decoder(clip.data.data(), N)
+        {
+        }
+
+        /**
+         * @brief Writes up to `count` samples and returns how many were written (0 at the end).
+         */
+        constexpr size_t render(int16_t* out, const size_t count)
+        {
+            const size_t n = count < samples - pos ? count : samples - pos;
+            for (size_t i = 0; i < n; ++i, ++pos)
+            {
+                const uint8_t byte = data[pos >> 1];
+                out[i] = decode_sample((pos & 1) ? byte >> 4 : byte & 0x0F, state);
+            }
+            return n;
+        }
+
+        // Back to the first sample.
+        constexpr void rewind()
+        {
+            pos = 0;
+            state = State{};
+        }
+
+        [[nodiscard]] constexpr bool done() const { return pos == samples; }
+
+    private:
+        const uint8_t* data;
+        size_t samples;
+        size_t pos = 0;
+        State state;
+    };
+} // namespace ems::adpcm
+
+#endif // EMS_ADPCM_HPP
@@ -0,0 +1,132 @@
+/**
+ * @file ems_dma.hpp
+ * @brief Circular-DMA double buffer for DAC / I2S output
+ * @license ISC License
+ *
+ * Hardware-agnostic glue between a sample source (e.g. ems::fixed::Synth) and a
+ * peripheral fed by circular DMA. The DMA streams the whole buffer in a loop and
+ * raises two interrupts per lap; each one hands back the half it just finished,
+ * which is refilled while the other half plays:
+ *
+ *   half-transfer      -> on_half_transfer()      refills [0, Half)
+ *   transfer-complete  -> on_transfer_complete()  refills [Half, 2 * Half)
+ *
+ * A refill renders exactly `Half` samples, so its cost is bounded by the block
+ * size, never by the song. No heap, no locks, and no atomic read-modify-write, so it
+ * builds on ARMv6-M (Cortex-M0/M0+) without libatomic.
+ *
+ * Usage (STM32 12-bit DAC, which takes unsigned codes 0..4095):
+ *   #include "ems_dma.hpp"
+ *
+ *   // Offsets the signed int16 samples to unsigned and shifts them down to 12 bits.
+ *   struct Dac12 {
+ *       ems::fixed::Synth<>& synth;
+ *       size_t render(uint16_t* out, size_t count) {
+ *           const size_t n = synth.render(reinterpret_cast<int16_t*>(out), count);
+ *           for (size_t i = 0; i < n; ++i) out[i] = static_cast<uint16_t>((out[i] ^ 0x8000) >> 4);
+ *           return n;
+ *       }
+ *   };
+ *
+ *   ems::fixed::Synth<> synth(score.data(), score.size(), 16000);
+ *   Dac12 dac{synth};
+ *   ems::dma::DoubleBuffer<Dac12, 128, uint16_t> out(dac, 2048); // silence = mid-scale
+ *
+ *   out.prime();
+ *   HAL_DAC_Start_DMA(&hdac, DAC_CHANNEL_1, reinterpret_cast<uint32_t*>(out.data()), out.size(), DAC_ALIGN_12B_R);
+ *
+ *   void HAL_DAC_ConvHalfCpltCallbackCh1(DAC_HandleTypeDef*) { out.on_half_transfer(); }
+ *   void HAL_DAC_ConvCpltCallbackCh1(DAC_HandleTypeDef*)     { out.on_transfer_complete(); }
+ */
+
+#ifndef EMS_DMA_HPP
+#define EMS_DMA_HPP
+
+#include <array>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+
+namespace ems::dma
+{
+    /**
+     * @brief Anything that can write the next `count` samples and report how many it wrote.
+     */
+    template <typename S, typename Sample>
+    concept SampleSource = requires(S& s, Sample* out, size_t count)
+    {
+        { s.render(out, count) } -> std::convertible_to<size_t>;
+    };
+
+    /**
+     * @brief Two-half DMA ring refilled from a SampleSource.
+     * @tparam Half Samples per half; one interrupt period is Half / sample_rate.
+     */
+    template <typename Source, size_t Half, typename Sample = int16_t>
+        requires SampleSource<Source, Sample>
+    class DoubleBuffer
+    {
+    public:
+        explicit DoubleBuffer(Source& source, const Sample silence = Sample{}) : source(source), silence(silence)
+        {
+        }
+
+        DoubleBuffer(const DoubleBuffer&) = delete;
+        DoubleBuffer& operator=(const DoubleBuffer&) = delete;
+
+        // Buffer handed to the DMA controller (circular mode, size() transfers).
+        [[nodiscard]] Sample* data() { return buffer.data(); }
+        [[nodiscard]] static constexpr size_t size() { return 2 * Half; }
+
+        // Fills both halves; call once before starting the DMA.
+        void prime()
+        {
+            refill(0);
+            refill(Half);
+        }
+
+        void on_half_transfer() { refill(0); }
+        void on_transfer_complete() { refill(Half); }
+
+        // True once the source has run dry and both halves hold only silence.
+        [[nodiscard]] bool finished() const { return silent_halves.load(std::memory_order_relaxed) >= 2; }
+
+        // Interrupts that arrived while the previous refill was still running.
+        [[nodiscard]] uint32_t overruns() const { return overrun_count.load(std::memory_order_relaxed); }
+
+    private:
+        /*
+         * Only the DMA interrupts write the state, and on a single core a nested interrupt
+         * runs to completion before the one it preempted resumes, so plain loads and stores
+         * are enough (and lock-free on every Cortex-M; exchange / fetch_add are not on M0).
+         */
+        void refill(const size_t offset)
+        {
+            // 上一次填充尚未结束又来中断：说明渲染超出了半缓冲周期
+            if (busy.load(std::memory_order_acquire))
+            {
+                overrun_count.store(overrun_count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                return;
+            }
+            busy.store(true, std::memory_order_relaxed);
+
+            Sample* half = buffer.data() + offset;
+            const size_t n = source.render(half, Half);
+            for (size_t i = n; i < Half; ++i) half[i] = silence;
+
+            const uint32_t silent = silent_halves.load(std::memory_order_relaxed);
+            silent_halves.store(n == 0 ? silent + 1 : 0, std::memory_order_relaxed);
+            busy.store(false, std::memory_order_release);
+        }
+
+        Source& source;
+        Sample silence;
+        std::array<Sample, 2 * Half> buffer{};
+        std::atomic<bool> busy{false};
+        std::atomic<uint32_t> overrun_count{0};
+        std::atomic<uint32_t> silent_halves{0};
+    };
+} // namespace ems::dma
+
+#endif // EMS_DMA_HPP
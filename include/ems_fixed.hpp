@@ -0,0 +1,259 @@
+/**
+ * @file ems_fixed.hpp
+ * @brief Integer-only EMS synthesiser (no FPU required)
+ * @license ISC License
+ *
+ * Renders `_ems` melodies to int16 PCM with a Q32 phase accumulator, a compile-time
+ * sine table and Q15 envelopes. Every runtime operation is integer add / multiply /
+ * shift with fully specified C++20 semantics, so the output is bit-identical on any
+ * target: a golden file rendered on the host validates what the MCU plays.
+ *
+ * Usage:
+ *   #include "ems_fixed.hpp"
+ *   using namespace ems::literals;
+ *
+ *   constexpr auto melody = "(120)1,2,3,"_ems;
+ *   constexpr auto score  = ems::fixed::compile<16000>(melody); // frequencies resolved at compile time
+ *
+ *   ems::fixed::Synth<> synth(score.data(), score.size(), 16000);
+ *   int16_t block[64];
+ *   while (const size_t n = synth.render(block, 64)) dac_write(block, n);
+ */
+
+#ifndef EMS_FIXED_HPP
+#define EMS_FIXED_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "ems_parser.hpp"
+
+namespace ems::fixed
+{
+    /**
+     * @brief A note ready for the integer synth.
+     */
+    struct Note
+    {
+        uint32_t phase_step; ///< Q32 phase increment per sample (2^32 = one cycle). 0 = Rest.
+        uint32_t samples; ///< Sounding length in samples, without the inter-note gap.
+    };
+
+    namespace internal
+    {
+        // sin(x) by range reduction to [-pi, pi] and a Taylor series; only used at compile time.
+        constexpr double sine(double x)
+        {
+            constexpr double pi = 3.14159265358979323846;
+            while (x > pi) x -= 2.0 * pi;
+            while (x < -pi) x += 2.0 * pi;
+
+            double term = x;
+            double sum = x;
+            for (int k = 1; k < 20; ++k)
+            {
+                term *= -x * x / static_cast<double>((2 * k) * (2 * k + 1));
+                sum += term;
+            }
+            return sum;
+        }
+
+        constexpr int32_t round_to_int(const double x)
+        {
+            return x >= 0.0 ? static_cast<int32_t>(x + 0.5) : -static_cast<int32_t>(-x + 0.5);
+        }
+    } // namespace internal
+
+    /**
+     * @brief One sine cycle in Q15, 2^Bits entries plus one guard entry for interpolation.
+     */
+    template <size_t Bits>
+    consteval std::array<int16_t, (size_t{1} << Bits) + 1> sine_table()
+    {
+        static_assert(Bits >= 4 && Bits <= 16, "sine table must have 2^4 .. 2^16 entries");
+        constexpr size_t Size = size_t{1} << Bits;
+        constexpr double pi = 3.14159265358979323846;
+
+        std::array<int16_t, Size + 1> table{};
+        for (size_t i = 0; i < Size; ++i)
+        {
+            const double x = 2.0 * pi * static_cast<double>(i) / static_cast<double>(Size);
+            table[i] = static_cast<int16_t>(internal::round_to_int(internal::sine(x) * 32767.0));
+        }
+        table[Size] = table[0];
+        return table;
+    }
+
+    // Q32 phase increment of a frequency ratio (relative to A4 = 440 Hz), clamped below Nyquist.
+    constexpr uint32_t phase_step(const float ratio, const uint32_t sample_rate)
+    {
+        if (ratio <= 0.0f) return 0;
+        const double step = 440.0 * static_cast<double>(ratio) * 4294967296.0 / static_cast<double>(sample_rate);
+        return step >= 2147483647.0 ? 2147483647u : static_cast<uint32_t>(step + 0.5);
+    }
+
+    /**
+     * @brief Resolves an `_ems` score for the integer synth at compile time,
+     * so the device never touches the float ratios.
+     */
+    template <uint32_t SampleRate, size_t N>
+    consteval std::array<Note, N> compile(const std::array<ems::Note, N>& notes)
+    {
+        std::array<Note, N> out{};
+        for (size_t i = 0; i < N; ++i)
+        {
+            out[i].phase_step = phase_step(notes[i].ratio, SampleRate);
+            out[i].samples = static_cast<uint32_t>(static_cast<uint64_t>(notes[i].duration_ms) * SampleRate / 1000);
+        }
+        return out;
+    }
+
+    /**
+     * @brief Streaming integer synthesiser.
+     *
+     * Sine lookup with linear interpolation, a linear attack / release envelope in Q15
+     * and a fixed output level, followed by the same 1 ms gap after each note as the
+     * float renderer. Roughly two multiplies and a table read per sample.
+     *
+     * @tparam TableBits log2 of the sine table size; 8 (514 bytes) is plenty at 16-bit output.
+     */
+    template <size_t TableBits = 8>
+    class Synth
+    {
+    public:
+        static constexpr int32_t amplitude = 6554; ///< 0.2 in Q15, the float renderer's level.
+
+        constexpr Synth(const Note* notes, const size_t count, const uint32_t sample_rate,
+                        const uint32_t attack_ms = 5, const uint32_t release_ms = 5)
+            : notes(notes), count(count), gap(sample_rate / 1000),
+              attack(static_cast<uint32_t>(static_cast<uint64_t>(attack_ms) * sample_rate / 1000)),
+              release(static_cast<uint32_t>(static_cast<uint64_t>(release_ms) * sample_rate / 1000))
+        {
+            if (count > 0) enter_note();
+        }
+
+        [[nodiscard]] constexpr bool done() const { return index >= count; }
+
+        /**
+         * @brief Writes up to `frames` samples and returns how many were written (0 at the end).
+         */
+        constexpr size_t render(int16_t* out, const size_t frames)
+        {
+            size_t written = 0;
+            while (written < frames && index < count)
+            {
+                if (left == 0)
+                {
+                    next_segment();
+                    continue;
+                }
+
+                const auto n = static_cast<uint32_t>(frames - written < left ? frames - written : left);
+                if (segment == Segment::Gap || step == 0)
+                {
+                    for (uint32_t i = 0; i < n; ++i) out[written + i] = 0;
+                    level += slope * static_cast<int32_t>(n);
+                }
+                else
+                {
+                    for (uint32_t i = 0; i < n; ++i)
+                    {
+                        const int32_t s = lookup(phase);
+                        const int32_t g = level >> 16; // Q15
+                        out[written + i] = static_cast<int16_t>((((s * g) >> 15) * amplitude) >> 15);
+                        phase += step;
+                        level += slope;
+                    }
+                }
+                written += n;
+                left -= n;
+            }
+            return written;
+        }
+
+    private:
+        static constexpr auto table = sine_table<TableBits>();
+        static constexpr int frac_bits = 15;
+        static constexpr int index_shift = 32 - static_cast<int>(TableBits);
+        static constexpr int32_t full = 32767 * 65536; // 包络满幅，Q15 << 16
+
+        enum class Segment : uint8_t
+        {
+            Attack,
+            Sustain,
+            Release,
+            Gap,
+        };
+
+        // Q15 sine of a Q32 phase, linearly interpolated between table entries.
+        static constexpr int32_t lookup(const uint32_t phase)
+        {
+            const uint32_t i = phase >> index_shift;
+            const auto frac = static_cast<int32_t>((phase >> (index_shift - frac_bits)) & 0x7FFF);
+            const int32_t a = table[i];
+            const int32_t b = table[i + 1];
+            return a + (((b - a) * frac) >> frac_bits);
+        }
+
+        constexpr void enter_note()
+        {
+            const Note& n = notes[index];
+            step = n.phase_step;
+            phase = 0;
+            // 与浮点包络一致：先保证释放段，短音符截断起音段（峰值随之降低）
+            release_len = release < n.samples ? release : n.samples;
+            attack_len = attack < n.samples - release_len ? attack : n.samples - release_len;
+            sustain_len = n.samples - attack_len - release_len;
+            segment = Segment::Attack;
+            left = attack_len;
+            level = 0;
+            slope = attack > 0 ? full / static_cast<int32_t>(attack) : 0;
+            if (attack == 0) level = full;
+        }
+
+        constexpr void next_segment()
+        {
+            switch (segment)
+            {
+            case Segment::Attack:
+                segment = Segment::Sustain;
+                left = sustain_len;
+                slope = 0;
+                break;
+            case Segment::Sustain:
+                segment = Segment::Release;
+                left = release_len;
+                slope = release_len > 0 ? -level / static_cast<int32_t>(release_len) : 0;
+                break;
+            case Segment::Release:
+                segment = Segment::Gap;
+                left = gap;
+                break;
+            case Segment::Gap:
+                if (++index < count) enter_note();
+                break;
+            }
+        }
+
+        const Note* notes;
+        size_t count;
+        size_t index = 0;
+
+        uint32_t gap;
+        uint32_t attack;
+        uint32_t release;
+        uint32_t attack_len = 0;
+        uint32_t sustain_len = 0;
+        uint32_t release_len = 0;
+
+        Segment segment = Segment::Attack;
+        uint32_t left = 0;
+        uint32_t phase = 0;
+        uint32_t step = 0;
+        int32_t level = 0; ///< Envelope level, Q15 << 16.
+        int32_t slope = 0;
+    };
+} // namespace ems::fixed
+
+#endif // EMS_FIXED_HPP
@@ -0,0 +1,176 @@
+/**
+ * @file ems_palette.hpp
+ * @brief One-byte-per-note scores through per-score pitch and duration palettes
+ * @license ISC License
+ *
+ * A parsed score stores a float ratio and a uint32_t duration per note (8 bytes),
+ * but most songs use only a handful of distinct pitches and note lengths:
+ * twinkle_star.ems has six pitches and two lengths. pack() collects the
+ * distinct values of a score into two small tables at compile time and stores each
+ * note as one byte, a 4-bit pitch index and a 4-bit duration index. Iterating a
+ * PackedScore yields ordinary ems::Note values, so it drops in wherever a Note
+ * array was walked.
+ *
+ * Usage:
+ *   #include "ems_palette.hpp"
+ *   using namespace ems::literals;
+ *
+ *   constexpr auto twinkle = "(120)1,1,5,5,6,6,5,,4,4,3,3,2,2,1,,"_ems;
+ *   static constexpr auto packed = ems::pack<twinkle>(); // 14 note bytes, 6 pitches, 2 durations
+ *
+ *   for (const ems::Note n : packed) play(n.ratio, n.duration_ms);
+ *
+ * A score with more than 16 distinct pitches (rest included) or durations does not
+ * compile; keep using the plain Note array for those.
+ */
+
+#ifndef EMS_PALETTE_HPP
+#define EMS_PALETTE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+#include "ems_parser.hpp"
+
+namespace ems
+{
+    /// Entries a 4-bit index can address.
+    inline constexpr size_t max_palette_size = 16;
+
+    /**
+     * @brief A score stored as palette indices.
+     * @tparam N Notes.
+     * @tparam P Distinct pitches (ratios, Rest included).
+     * @tparam D Distinct durations.
+     */
+    template <size_t N, size_t P, size_t D>
+    struct PackedScore
+    {
+        std::array<float, P> pitches; ///< Pitch palette, in order of first use.
+        std::array<uint32_t, D> durations; ///< Duration palette (ms), in order of first use.
+        std::array<uint8_t, N> codes; ///< Per note: pitch index << 4 | duration index.
+
+        // Decodes note `i`.
+        constexpr Note operator[](const size_t i) const
+        {
+            return Note{pitches[codes[i] >> 4], durations[codes[i] & 0x0F]};
+        }
+
+        static constexpr size_t size() { return N; }
+
+        /**
+         * @brief Forward iterator decoding one note per step.
+         */
+        class Iterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = Note;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = Note;
+
+            constexpr Iterator() = default;
+            constexpr Iterator(const PackedScore* score, const size_t index) : score(score), index(index)
+            {
+            }
+
+            constexpr Note operator*() const { return (*score)[index]; }
+
+            constexpr Iterator& operator++()
+            {
+                index++;
+                return *this;
+            }
+
+            constexpr Iterator operator++(int)
+            {
+                Iterator old = *this;
+                index++;
+                return old;
+            }
+
+            constexpr bool operator==(const Iterator& other) const { return index == other.index; }
+
+        private:
+            const PackedScore* score = nullptr;
+            size_t index = 0;
+        };
+
+        constexpr Iterator begin() const { return Iterator(this, 0); }
+        constexpr Iterator end() const { return Iterator(this, N); }
+    };
+
+    namespace internal
+    {
+        // 按首次出现的顺序收集不同的取值；返回个数
+        template <typename T, size_t N, typename Key>
+        constexpr size_t collect(const std::array<Note, N>& melody, Key key, T* out)
+        {
+            size_t count = 0;
+            for (const auto& n : melody)
+            {
+                const T value = key(n);
+                size_t i = 0;
+                while (i < count && out[i] != value) i++;
+                if (i == count)
+                {
+                    if (count == max_palette_size) return max_palette_size + 1;
+                    out[count++] = value;
+                }
+            }
+            return count;
+        }
+
+        constexpr float ratio_of(const Note& n) { return n.ratio; }
+        constexpr uint32_t duration_of(const Note& n) { return n.duration_ms; }
+
+        template <typename T, size_t N, typename Key>
+        constexpr size_t palette_size(const std::array<Note, N>& melody, Key key)
+        {
+            T values[max_palette_size]{};
+            return collect<T>(melody, key, values);
+        }
+
+        template <typename T, size_t Size>
+        constexpr uint8_t index_of(const std::array<T, Size>& palette, const T value)
+        {
+            uint8_t i = 0;
+            while (palette[i] != value) i++;
+            return i;
+        }
+    } // namespace internal
+
+    /**
+     * @brief Packs `Melody` (a std::array<Note, N>, e.g. from `_ems`) at compile time.
+     *
+     * The melody is a template argument because the palette sizes are part of the type.
+     */
+    template <auto Melody>
+    consteval auto pack()
+    {
+        constexpr size_t N = Melody.size();
+        constexpr size_t P = internal::palette_size<float>(Melody, internal::ratio_of);
+        constexpr size_t D = internal::palette_size<uint32_t>(Melody, internal::duration_of);
+        static_assert(P <= max_palette_size, "ems::pack: more than 16 distinct pitches");
+        static_assert(D <= max_palette_size, "ems::pack: more than 16 distinct durations");
+        if constexpr (P > max_palette_size || D > max_palette_size) return PackedScore<N, 0, 0>{};
+        else
+        {
+            PackedScore<N, P, D> packed{};
+            internal::collect<float>(Melody, internal::ratio_of, packed.pitches.data());
+            internal::collect<uint32_t>(Melody, internal::duration_of, packed.durations.data());
+            for (size_t i = 0; i < N; ++i)
+            {
+                const uint8_t pitch = internal::index_of(packed.pitches, Melody[i].ratio);
+                const uint8_t duration = internal::index_of(packed.durations, Melody[i].duration_ms);
+                packed.codes[i] = static_cast<uint8_t>(pitch << 4 | duration);
+            }
+            return packed;
+        }
+    }
+} // namespace ems
+
+#endif // EMS_PALETTE_HPP
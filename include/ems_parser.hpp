@@ -47,10 +47,80 @@ namespace ems
         uint32_t duration_ms; ///< Duration in milliseconds.
     };
 
+    /**
+     * @brief How a note is played, from the marks `~` `'` `=` `>` after it.
+     * The parser only records the mark; players map it to their own envelope.
+     */
+    enum class Articulation : uint8_t
+    {
+        Normal,
+        Legato, ///< `~` Connected to the next note.
+        Staccato, ///< `'` Short, detached.
+        Tenuto, ///< `=` Held for the full value.
+        Accent, ///< `>` Louder attack.
+    };
+
+    /**
+     * @brief A note with its articulation mark, produced by `_ems_art`.
+     * Kept apart from Note so that scores without marks stay 8 bytes per note.
+     */
+    struct ArticulatedNote
+    {
+        float ratio; ///< Frequency ratio (see Note::ratio). 0.0 = Rest.
+        uint32_t duration_ms; ///< Duration in milliseconds.
+        Articulation articulation; ///< Mark written after the note; Normal if none.
+    };
+
+    /// Widest chord the parser keeps; further chord tones are dropped.
+    inline constexpr size_t max_chord_voices = 8;
+
+    /**
+     * @brief A chord event produced by `_ems_poly`.
+     * V is the widest chord in the score. Every event has the same V slots, and the
+     * unused ones hold ratio 0.0 (silence), so renderers can process all slots
+     * unconditionally.
+     */
+    template <size_t V>
+    struct Chord
+    {
+        std::array<float, V> ratios; ///< Frequency ratios, 0.0 = silent slot.
+        uint8_t voices; ///< Number of slots actually used by this event.
+        uint32_t duration_ms; ///< Duration in milliseconds.
+    };
+
+    /// Tick resolution of `_ems_ticks` (pulses per beat); every duration modifier is a whole number of ticks.
+    inline constexpr uint32_t ppq = 480;
+
+    /**
+     * @brief A note whose length is kept in ticks instead of milliseconds.
+     * The tempo is applied at playback time (see ems_tempo.hpp), so changing it does
+     * not touch the notes and tick positions never accumulate rounding error.
+     */
+    struct TickNote
+    {
+        float ratio; ///< Frequency ratio (see Note::ratio). 0.0 = Rest.
+        uint32_t ticks; ///< Duration in ticks, `ppq` per beat.
+    };
+
+    /**
+     * @brief Result of `_ems_ticks`: the notes plus the tempo written in the score header.
+     */
+    template <size_t N>
+    struct TickScore
+    {
+        uint32_t bpm; ///< Tempo from the (BPM) header, the playback default.
+        std::array<TickNote, N> notes;
+
+        constexpr const TickNote* begin() const { return notes.data(); }
+        constexpr const TickNote* end() const { return notes.data() + N; }
+        constexpr const TickNote& operator[](const size_t i) const { return notes[i]; }
+        static constexpr size_t size() { return N; }
+    };
+
     namespace internal
     {
         // Compile-time power function approximation for float
-        consteval float power(const float base, const int exp)
+        constexpr float power(const float base, const int exp)
         {
             if (exp == 0) return 1.0f;
             if (exp < 0) return 1.0f / power(base, -exp);
@@ -60,7 +130,7 @@ namespace ems
         }
 
         // 基于 A4=440Hz 的频率比（倍频）计算：返回 freq / 440.0f
-        consteval float calculate_ratio(const int note_num,
+        constexpr float calculate_ratio(const int note_num,
                                         const int octave_offset,
                                         const int semitone_offset)
         {
@@ -80,7 +150,7 @@ namespace ems
         }
 
         // Helper to parse integer from string_view
-        consteval int parse_int(const std::string_view sv, size_t& idx)
+        constexpr int parse_int(const std::string_view sv, size_t& idx)
         {
             int val = 0;
             while (idx < sv.size() && sv[idx] >= '0' && sv[idx] <= '9')
@@ -100,7 +170,7 @@ namespace ems
         class Parser
         {
         public:
-            static consteval size_t count_notes(const std::string_view score)
+            static constexpr size_t count_notes(const std::string_view score)
             {
                 size_t count = 0;
                 size_t i = 0;
@@ -126,6 +196,12 @@ namespace ems
                         count++;
                         i++;
                     }
+                    else if (c == '[')
+                    {
+                        // A chord is a single event
+                        count++;
+                        while (i < score.size() && score[i] != ']') i++;
+                    }
                     else
                     {
                         i++;
@@ -137,10 +213,177 @@ namespace ems
             template <size_t N>
             static consteval std::array<Note, N> parse(std::string_view score)
             {
+                if (!valid_tempo(score)) throw "ems: the (BPM) header must be a positive tempo";
                 std::array<Note, N> notes{};
+                parse_into(score, notes.data(), N);
+                return notes;
+            }
+
+            template <size_t N, size_t V>
+            static consteval std::array<Chord<V>, N> parse_poly(std::string_view score)
+            {
+                if (!valid_tempo(score)) throw "ems: the (BPM) header must be a positive tempo";
+                std::array<Chord<V>, N> chords{};
+                walk(score, N, [&](const size_t idx, const float* ratios, const size_t voices, const uint32_t duration_ms, float,
+                                   Articulation)
+                {
+                    const size_t used = std::min(voices, V);
+                    for (size_t v = 0; v < used; ++v) chords[idx].ratios[v] = ratios[v];
+                    chords[idx].voices = static_cast<uint8_t>(used);
+                    chords[idx].duration_ms = duration_ms;
+                });
+                return chords;
+            }
+
+            template <size_t N>
+            static consteval std::array<ArticulatedNote, N> parse_articulated(std::string_view score)
+            {
+                if (!valid_tempo(score)) throw "ems: the (BPM) header must be a positive tempo";
+                std::array<ArticulatedNote, N> notes{};
+                walk(score, N, [&](const size_t idx, const float* ratios, size_t, const uint32_t duration_ms, float,
+                                   const Articulation articulation)
+                {
+                    notes[idx].ratio = ratios[0];
+                    notes[idx].duration_ms = duration_ms;
+                    notes[idx].articulation = articulation;
+                });
+                return notes;
+            }
+
+            template <size_t N>
+            static consteval TickScore<N> parse_ticks(std::string_view score)
+            {
+                if (!valid_tempo(score)) throw "ems: the (BPM) header must be a positive tempo";
+                TickScore<N> result{};
+                size_t i = 0;
+                result.bpm = static_cast<uint32_t>(parse_bpm(score, i));
+                walk(score, N, [&](const size_t idx, const float* ratios, size_t, uint32_t, const float beats, Articulation)
+                {
+                    // 时值均为 1/4 拍的整数倍，乘以 ppq 没有舍入
+                    result.notes[idx].ratio = ratios[0];
+                    result.notes[idx].ticks = static_cast<uint32_t>(beats * static_cast<float>(ppq));
+                });
+                return result;
+            }
+
+            // Shared by the compile-time literal and the runtime entry point.
+            // Writes at most `capacity` notes and returns how many were written (0 for a zero tempo).
+            // A chord contributes its first note, so monophonic players still get the melody line.
+            static constexpr size_t parse_into(std::string_view score, Note* notes, const size_t capacity)
+            {
+                return walk(score, capacity, [&](const size_t idx, const float* ratios, size_t, const uint32_t duration_ms, float,
+                                                 Articulation)
+                {
+                    notes[idx].ratio = ratios[0];
+                    notes[idx].duration_ms = duration_ms;
+                });
+            }
+
+            /**
+             * @brief Visits every note / chord event of the score in order.
+             * `emit(index, ratios, voice_count, duration_ms, beats, articulation)` is called once per
+             * event; a plain note is a one-voice event, and a chord takes the mark of its first tone. Returns the number of events visited; a score
+             * whose header gives a zero tempo ("(0)", "()") has no valid durations and visits none.
+             */
+            template <typename Emit>
+            static constexpr size_t walk(std::string_view score, const size_t capacity, Emit&& emit)
+            {
                 size_t note_idx = 0;
                 size_t i = 0;
 
+                if (!valid_tempo(score)) return 0;
+                const float ms_per_beat = parse_header(score, i);
+
+                // --- 2. Body Parsing ---
+                while (i < score.size() && note_idx < capacity)
+                {
+                    if (const char c = score[i]; (c >= '0' && c <= '7') || c == '`')
+                    {
+                        float dur_mult = 0.0f;
+                        Articulation articulation = Articulation::Normal;
+                        const float ratio = parse_note(score, i, dur_mult, articulation);
+                        emit(note_idx, &ratio, 1, static_cast<uint32_t>(ms_per_beat * dur_mult), dur_mult,
+                             articulation);
+                        note_idx++;
+                    }
+                    else if (c == '[')
+                    {
+                        // Chord: [135], pitches inside the brackets, one shared duration after them.
+                        float ratios[max_chord_voices]{};
+                        Articulation marks[max_chord_voices]{};
+                        size_t voices = 0;
+                        i++;
+                        while (i < score.size() && score[i] != ']')
+                        {
+                            if (const char v = score[i]; (v >= '0' && v <= '7') || v == '`')
+                            {
+                                float ignored = 0.0f;
+                                Articulation articulation = Articulation::Normal;
+                                const float ratio = parse_note(score, i, ignored, articulation);
+                                if (voices < max_chord_voices)
+                                {
+                                    marks[voices] = articulation;
+                                    ratios[voices++] = ratio;
+                                }
+                            }
+                            else
+                            {
+                                i++;
+                            }
+                        }
+                        if (i < score.size()) i++; // ]
+
+                        const float dur_mult = parse_duration(score, i);
+                        emit(note_idx, ratios, voices == 0 ? 1 : voices, static_cast<uint32_t>(ms_per_beat * dur_mult),
+                             dur_mult, marks[0]);
+                        note_idx++;
+                    }
+                    else
+                    {
+                        i++;
+                    }
+                }
+                return note_idx;
+            }
+
+            // False when the (BPM) header gives a tempo of 0.
+            static constexpr bool valid_tempo(const std::string_view score)
+            {
+                size_t i = 0;
+                return parse_bpm(score, i) > 0.0f;
+            }
+
+            // Largest chord in the score (1 for purely monophonic scores), capped at max_chord_voices.
+            static constexpr size_t max_voices(const std::string_view score)
+            {
+                size_t widest = 1;
+                size_t i = 0;
+                while (i < score.size())
+                {
+                    if (score[i] == '[')
+                    {
+                        size_t voices = 0;
+                        while (i < score.size() && score[i] != ']')
+                        {
+                            if (score[i] >= '0' && score[i] <= '7') voices++;
+                            i++;
+                        }
+                        widest = std::max(widest, std::min(voices, max_chord_voices));
+                    }
+                    i++;
+                }
+                return widest;
+            }
+
+        private:
+            // (BPM) header; returns milliseconds per beat and leaves `i` on the body.
+            static constexpr float parse_header(const std::string_view score, size_t& i)
+            {
+                return 60000.0f / parse_bpm(score, i);
+            }
+
+            static constexpr float parse_bpm(const std::string_view score, size_t& i)
+            {
                 float bpm = 120.0f;
 
                 // --- 1. Header Parsing ---
@@ -151,89 +394,110 @@ namespace ems
                     if (i < score.size() && score[i] == ')') i++;
                 }
 
-                const float ms_per_beat = 60000.0f / bpm;
+                return bpm;
+            }
 
-                // --- 2. Body Parsing ---
-                while (i < score.size() && note_idx < N)
+            // Parses one note starting at `i`; returns its ratio, adds its beats to `dur_mult` and
+            // stores its articulation mark, if any, in `articulation`.
+            static constexpr float parse_note(const std::string_view score, size_t& i, float& dur_mult,
+                                              Articulation& articulation)
+            {
+                int num = 0;
+                int oct = 0;
+                int semi = 0;
+
+                // 1. Prefix Octave (Lower)
+                if (score[i] == '`')
                 {
-                    if (const char c = score[i]; (c >= '0' && c <= '7') || c == '`')
-                    {
-                        int num = 0;
-                        int oct = 0;
-                        int semi = 0;
-                        float dur_mult = 0.0f;
+                    oct--; // 降八度
+                    i++;
+                }
 
-                        // 1. Prefix Octave (Lower)
-                        if (score[i] == '`')
-                        {
-                            oct--; // 降八度
-                            i++;
-                        }
+                // 2. Note Number
+                if (i < score.size() && score[i] >= '0' && score[i] <= '7')
+                {
+                    num = score[i] - '0';
+                    i++;
+                }
+
+                // 3. Suffix Modifiers
+                // 防止混淆 Duration 后面的 Pitch 修饰符
+                bool parsing_duration = false;
+                bool loop = true;
 
-                        // 2. Note Number
-                        if (i < score.size() && score[i] >= '0' && score[i] <= '7')
+                while (i < score.size() && loop)
+                {
+                    const char mod = score[i];
+                    switch (mod)
+                    {
+                    // --- Pitch Modifiers ---
+                    case 's':
+                    case 'b':
+                    case '`':
+                        if (parsing_duration)
                         {
-                            num = score[i] - '0';
-                            i++;
+                            // 如果已经进入时长模式，再次遇到音高修饰符（如 `），
+                            // 说明这是下一个音符的前缀，立即停止当前解析。
+                            loop = false;
+                            continue; // 不消耗字符 i
                         }
+                        if (mod == 's') semi++;
+                        else if (mod == 'b') semi--;
+                        else { oct++; } // `
+                        break;
 
-                        // 3. Suffix Modifiers
-                        // 防止混淆 Duration 后面的 Pitch 修饰符
-                        bool parsing_duration = false;
-                        bool loop = true;
+                    // --- Duration Modifiers ---
+                    case ',':
+                    case '-':
+                    case '.':
+                    case '_':
+                        dur_mult += parse_duration(score, i);
+                        parsing_duration = true;
+                        continue; // parse_duration 已消耗字符
 
-                        while (i < score.size() && loop)
-                        {
-                            const char mod = score[i];
-                            switch (mod)
-                            {
-                            // --- Pitch Modifiers ---
-                            case 's':
-                            case 'b':
-                            case '`':
-                                if (parsing_duration)
-                                {
-                                    // 如果已经进入时长模式，再次遇到音高修饰符（如 `），
-                                    // 说明这是下一个音符的前缀，立即停止当前解析。
-                                    loop = false;
-                                    continue; // 不消耗字符 i
-                                }
-                                if (mod == 's') semi++;
-                                else if (mod == 'b') semi--;
-                                else { oct++; } // `
-                                break;
-
-                            // --- Duration Modifiers ---
-                            case ',': dur_mult += 1.0f;
-                                parsing_duration = true;
-                                break;
-                            case '-': dur_mult += 0.5f;
-                                parsing_duration = true;
-                                break;
-                            case '.': dur_mult += 0.25f;
-                                parsing_duration = true;
-                                break;
-                            case '_': dur_mult += 2.0f;
-                                parsing_duration = true;
-                                break;
-
-                            default:
-                                loop = false;
-                                continue; // 不消耗字符 i
-                            }
-                            i++; // 消耗有效的修饰符
-                        }
+                    // --- Articulation Marks ---
+                    // 不会开始下一个音符，时值前后都可以出现
+                    case '~': articulation = Articulation::Legato;
+                        break;
+                    case '\'': articulation = Articulation::Staccato;
+                        break;
+                    case '=': articulation = Articulation::Tenuto;
+                        break;
+                    case '>': articulation = Articulation::Accent;
+                        break;
 
-                        notes[note_idx].ratio = calculate_ratio(num, oct, semi);
-                        notes[note_idx].duration_ms = static_cast<uint32_t>(ms_per_beat * dur_mult);
-                        note_idx++;
+                    default:
+                        loop = false;
+                        continue; // 不消耗字符 i
                     }
-                    else
+                    i++; // 消耗有效的修饰符
+                }
+
+                return calculate_ratio(num, oct, semi);
+            }
+
+            // Consumes a run of duration modifiers and returns the beat multiplier.
+            static constexpr float parse_duration(const std::string_view score, size_t& i)
+            {
+                float dur_mult = 0.0f;
+                while (i < score.size())
+                {
+                    switch (score[i])
                     {
-                        i++;
+                    case ',': dur_mult += 1.0f;
+                        break;
+                    case '-': dur_mult += 0.5f;
+                        break;
+                    case '.': dur_mult += 0.25f;
+                        break;
+                    case '_': dur_mult += 2.0f;
+                        break;
+                    default:
+                        return dur_mult;
                     }
+                    i++;
                 }
-                return notes;
+                return dur_mult;
             }
         };
 
@@ -250,6 +514,25 @@ namespace ems
         };
     } // namespace internal
 
+    /**
+     * @brief Runtime parsing, for scores only known at run time (files, tools).
+     * Size the output with count_notes(); no heap is used by the parser itself.
+     * parse() returns 0 for a score with a zero tempo header, which the literals reject
+     * at compile time.
+     *
+     *   std::vector<ems::Note> notes(ems::count_notes(text));
+     *   notes.resize(ems::parse(text, notes.data(), notes.size()));
+     */
+    constexpr size_t count_notes(const std::string_view score)
+    {
+        return internal::Parser::count_notes(score);
+    }
+
+    constexpr size_t parse(const std::string_view score, Note* out, const size_t capacity)
+    {
+        return internal::Parser::parse_into(score, out, capacity);
+    }
+
     // Public API: User Defined Literal
     namespace literals
     {
@@ -260,6 +543,44 @@ namespace ems
             constexpr size_t N = internal::Parser::count_notes(sv);
             return internal::Parser::parse<N>(sv);
         }
+
+        /**
+         * @brief Polyphonic variant: chords like `[135],` keep all their tones.
+         *   constexpr auto song = "(120)[135],[146],[257],[135]_"_ems_poly; // std::array<Chord<3>, 4>
+         */
+        template <internal::StringLiteral Lit>
+        consteval auto operator""_ems_poly()
+        {
+            constexpr std::string_view sv{Lit.value, sizeof(Lit.value) - 1};
+            constexpr size_t N = internal::Parser::count_notes(sv);
+            constexpr size_t V = internal::Parser::max_voices(sv);
+            return internal::Parser::parse_poly<N, V>(sv);
+        }
+
+        /**
+         * @brief Articulated variant: notes keep the mark written after them.
+         *   constexpr auto song = "(120)1,'2,'3>_4~-5=,"_ems_art; // std::array<ArticulatedNote, 5>
+         * `_ems` and the other literals accept the same marks and ignore them.
+         */
+        template <internal::StringLiteral Lit>
+        consteval auto operator""_ems_art()
+        {
+            constexpr std::string_view sv{Lit.value, sizeof(Lit.value) - 1};
+            constexpr size_t N = internal::Parser::count_notes(sv);
+            return internal::Parser::parse_articulated<N>(sv);
+        }
+
+        /**
+         * @brief Tick variant: durations in `ppq` ticks, tempo left to the player.
+         *   constexpr auto song = "(120)1,2-3."_ems_ticks; // song.bpm == 120, song[0].ticks == 480
+         */
+        template <internal::StringLiteral Lit>
+        consteval auto operator""_ems_ticks()
+        {
+            constexpr std::string_view sv{Lit.value, sizeof(Lit.value) - 1};
+            constexpr size_t N = internal::Parser::count_notes(sv);
+            return internal::Parser::parse_ticks<N>(sv);
+        }
     } // namespace literals
 } // namespace ems
 
@@ -0,0 +1,126 @@
+/**
+ * @file ems_pdm.hpp
+ * @brief 1-bit PDM (sigma-delta) output for GPIO / single-pin audio
+ * @license ISC License
+ *
+ * Turns int16 PCM from any sample source (e.g. ems::fixed::Synth) into a packed
+ * pulse-density bitstream, 32 output bits per uint32_t, at `Oversampling` bits per
+ * PCM sample. Stream the words to a pin with SPI/I2S in DMA mode or a DMA-to-GPIO
+ * transfer; an RC low-pass or the piezo itself does the reconstruction.
+ *
+ * The modulator is first order. Each PCM sample is held for its Oversampling bits,
+ * so every bit of a word has a closed form and none depends on the previous bit:
+ * the 32-bit kernel is branch-free and vectorises on hosts, and on an MCU it is a
+ * short unrolled add / shift sequence per word.
+ *
+ * Usage:
+ *   #include "ems_pdm.hpp"
+ *
+ *   ems::fixed::Synth<> synth(score.data(), score.size(), 16000);
+ *   ems::pdm::Modulator<ems::fixed::Synth<>, 64> pdm(synth); // 1.024 Mbit/s
+ *   uint32_t words[64];
+ *   while (const size_t n = pdm.render(words, 64)) spi_dma_write(words, n);
+ */
+
+#ifndef EMS_PDM_HPP
+#define EMS_PDM_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ems::pdm
+{
+    /**
+     * @brief 32 bits of first-order sigma-delta for a constant input.
+     * @param level Input density in Q16 (0 = all zeros, 65535 = almost all ones).
+     * @param acc Integrator (Q16 remainder), carried from word to word.
+     * @tparam MsbFirst Place the first bit in bit 31 (SPI / I2S order) instead of bit 0.
+     *
+     * Bit k is 1 exactly when acc + (k + 1) * level crosses a multiple of 2^16, which is
+     * what the integrate-and-compare loop produces, without the loop-carried state.
+     */
+    template <bool MsbFirst = true>
+    constexpr uint32_t encode_word(const uint32_t level, uint32_t& acc)
+    {
+        uint32_t bits = 0;
+        for (uint32_t k = 0; k < 32; ++k)
+        {
+            const uint32_t before = acc + k * level;
+            const uint32_t bit = ((before + level) >> 16) - (before >> 16);
+            bits |= bit << (MsbFirst ? 31 - k : k);
+        }
+        acc = (acc + 32 * level) & 0xFFFF;
+        return bits;
+    }
+
+    // int16 sample to Q16 density; 0 maps to 50 % ones (the idle pattern).
+    constexpr uint32_t density(const int16_t sample)
+    {
+        return static_cast<uint32_t>(static_cast<int32_t>(sample) + 32768);
+    }
+
+    /**
+     * @brief Pulls int16 PCM from `Source` and emits packed PDM words.
+     * @tparam Oversampling Output bits per PCM sample, a multiple of 32.
+     *
+     * `Source` needs `size_t render(int16_t* out, size_t count)`, returning 0 at the end.
+     */
+    template <typename Source, uint32_t Oversampling = 64, bool MsbFirst = true>
+    class Modulator
+    {
+        static_assert(Oversampling >= 32 && Oversampling % 32 == 0, "oversampling must be a multiple of 32 bits");
+
+    public:
+        static constexpr uint32_t words_per_sample = Oversampling / 32;
+
+        constexpr explicit Modulator(Source& source) : source(source)
+        {
+        }
+
+        [[nodiscard]] constexpr bool done() const { return finished && pos == filled && repeat == 0; }
+
+        /**
+         * @brief Writes up to `count` words and returns how many were written (0 at the end).
+         */
+        constexpr size_t render(uint32_t* words, const size_t count)
+        {
+            size_t written = 0;
+            while (written < count)
+            {
+                if (repeat == 0)
+                {
+                    if (pos == filled && !refill()) break;
+                    level = density(pcm[pos++]);
+                    repeat = words_per_sample;
+                }
+                words[written++] = encode_word<MsbFirst>(level, acc);
+                repeat--;
+            }
+            return written;
+        }
+
+    private:
+        static constexpr size_t block = 32;
+
+        constexpr bool refill()
+        {
+            if (finished) return false;
+            filled = source.render(pcm, block);
+            pos = 0;
+            finished = filled < block;
+            return filled > 0;
+        }
+
+        Source& source;
+        int16_t pcm[block]{};
+        size_t filled = 0;
+        size_t pos = 0;
+        bool finished = false;
+
+        uint32_t level = 0;
+        uint32_t acc = 0;
+        uint32_t repeat = 0;
+    };
+} // namespace ems::pdm
+
+#endif // EMS_PDM_HPP
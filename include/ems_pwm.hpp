@@ -0,0 +1,181 @@
+/**
+ * @file ems_pwm.hpp
+ * @brief Compile-time PWM timer schedules for EMS scores
+ * @license ISC License
+ *
+ * Boards that play tones by retuning a PWM timer need, per note, a prescaler, an
+ * auto-reload (period) and a compare (duty) value. schedule() computes them at
+ * compile time for a given timer clock, choosing for every note the prescaler with
+ * the smallest pitch error. Durations are counted in timer update events, so the
+ * timer's own update interrupt drives ToneSequencer and nothing else is needed.
+ *
+ * Usage:
+ *   #include "ems_pwm.hpp"
+ *   using namespace ems::literals;
+ *
+ *   constexpr auto melody = "(120)1,2,3,"_ems;
+ *   constexpr auto steps  = ems::pwm::schedule(melody, 72'000'000); // 72 MHz timer clock, 50% duty
+ *
+ *   ems::pwm::ToneSequencer seq(steps.data(), steps.size());
+ *   program(*seq.start());
+ *
+ *   void TIM3_IRQHandler() {
+ *       TIM3->SR = ~TIM_SR_UIF;
+ *       if (const auto* s = seq.on_update()) program(*s); // PSC, ARR, CCR (preloaded)
+ *   }
+ */
+
+#ifndef EMS_PWM_HPP
+#define EMS_PWM_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "ems_parser.hpp"
+
+namespace ems::pwm
+{
+    /**
+     * @brief Register values for one note, in the usual "value + 1" timer convention.
+     */
+    struct Step
+    {
+        uint16_t prescaler; ///< Counter clock = timer clock / (prescaler + 1).
+        uint16_t auto_reload; ///< PWM period = auto_reload + 1 counter ticks.
+        uint16_t compare; ///< Output high for `compare` ticks per period; 0 = Rest (output held low).
+        uint32_t duration_ticks; ///< Update events (PWM periods) the note lasts.
+    };
+
+    /// Update rate used while resting, so rests are timed like notes.
+    inline constexpr uint32_t rest_rate_hz = 1000;
+
+    namespace internal
+    {
+        struct Divider
+        {
+            uint32_t prescaler; // divide by (prescaler + 1)
+            uint32_t period; // auto_reload + 1
+            double error; // |f_actual - f| in Hz
+        };
+
+        constexpr double abs(const double x) { return x < 0.0 ? -x : x; }
+
+        // Best prescaler / period pair for `freq`; period is kept in [2, counter_max + 1].
+        constexpr Divider divider(const double freq, const uint32_t clock_hz, const uint32_t counter_max)
+        {
+            const double cycles = static_cast<double>(clock_hz) / freq; // 总分频数
+            Divider best{0, 0, -1.0};
+
+            // Smallest prescaler that fits the period in the counter; larger ones only lose resolution,
+            // but may hit an exact divisor, so the search continues until the period gets too coarse.
+            auto psc = static_cast<uint32_t>(cycles / (static_cast<double>(counter_max) + 1.0));
+            for (; psc <= 0xFFFF; ++psc)
+            {
+                const double ideal = cycles / static_cast<double>(psc + 1);
+                if (ideal < 2.0) break;
+                for (auto period = static_cast<uint32_t>(ideal); period <= static_cast<uint32_t>(ideal) + 1; ++period)
+                {
+                    if (period < 2 || period > counter_max + 1) continue;
+                    const double actual = static_cast<double>(clock_hz) / (static_cast<double>(psc + 1) * period);
+                    const double error = abs(actual - freq);
+                    if (best.error < 0.0 || error < best.error) best = Divider{psc, period, error};
+                }
+                if (best.error == 0.0 || ideal < 64.0) break;
+            }
+            return best;
+        }
+    } // namespace internal
+
+    /**
+     * @brief Builds the timer schedule of a score.
+     * @param clock_hz Timer input clock.
+     * @param duty Fraction of each period the output is high (0.5 = square wave).
+     * @param counter_max Largest auto-reload value (0xFFFF for a 16-bit timer).
+     */
+    template <size_t N>
+    consteval std::array<Step, N> schedule(const std::array<Note, N>& notes, const uint32_t clock_hz,
+                                           const float duty = 0.5f, const uint32_t counter_max = 0xFFFF)
+    {
+        std::array<Step, N> steps{};
+        for (size_t i = 0; i < N; ++i)
+        {
+            const bool rest = notes[i].ratio <= 0.0f;
+            const double freq = rest ? rest_rate_hz : 440.0 * static_cast<double>(notes[i].ratio);
+            const internal::Divider d = internal::divider(freq, clock_hz, counter_max);
+            if (d.error < 0.0) throw "ems::pwm::schedule: note out of the timer's range";
+
+            const double actual = static_cast<double>(clock_hz) / (static_cast<double>(d.prescaler + 1) * d.period);
+            const double periods = static_cast<double>(notes[i].duration_ms) * actual / 1000.0;
+
+            steps[i].prescaler = static_cast<uint16_t>(d.prescaler);
+            steps[i].auto_reload = static_cast<uint16_t>(d.period - 1);
+            steps[i].compare = rest ? 0 : static_cast<uint16_t>(static_cast<double>(d.period) * duty + 0.5);
+            steps[i].duration_ticks = notes[i].duration_ms == 0 ? 0 : static_cast<uint32_t>(periods + 0.5);
+            if (notes[i].duration_ms > 0 && steps[i].duration_ticks == 0) steps[i].duration_ticks = 1;
+        }
+        return steps;
+    }
+
+    // Output frequency of a step; for checking schedules against the score.
+    constexpr double frequency(const Step& step, const uint32_t clock_hz)
+    {
+        return static_cast<double>(clock_hz) / ((step.prescaler + 1.0) * (step.auto_reload + 1.0));
+    }
+
+    /**
+     * @brief Steps through a schedule from the timer update interrupt.
+     *
+     * Each update costs one decrement and one compare; only when a note ends does the
+     * ISR get a Step back to program (prescaler, auto-reload, compare). With register
+     * preload enabled the new values take effect on the following update, glitch-free.
+     */
+    class ToneSequencer
+    {
+    public:
+        constexpr ToneSequencer(const Step* steps, const size_t count) : steps(steps), count(count)
+        {
+        }
+
+        // Rewinds and returns the first step to program before enabling the timer (nullptr if empty).
+        constexpr const Step* start()
+        {
+            index = 0;
+            skip_empty();
+            if (index == count) return nullptr;
+            left = steps[index].duration_ticks;
+            return &steps[index];
+        }
+
+        // Timer update interrupt. Returns the next step when a note boundary is reached, else nullptr.
+        constexpr const Step* on_update()
+        {
+            if (index == count || --left != 0) return nullptr;
+
+            index++;
+            skip_empty();
+            if (index == count) return &silence;
+            left = steps[index].duration_ticks;
+            return &steps[index];
+        }
+
+        [[nodiscard]] constexpr bool finished() const { return index == count; }
+        [[nodiscard]] constexpr size_t position() const { return index; }
+
+    private:
+        // 跳过零时长的音符
+        constexpr void skip_empty()
+        {
+            while (index < count && steps[index].duration_ticks == 0) index++;
+        }
+
+        static constexpr Step silence{0, 0xFFFF, 0, 0}; ///< Programmed once at the end: output low.
+
+        const Step* steps;
+        size_t count;
+        size_t index = 0;
+        uint32_t left = 0;
+    };
+} // namespace ems::pwm
+
+#endif // EMS_PWM_HPP
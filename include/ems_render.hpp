@@ -0,0 +1,99 @@
+/**
+ * @file ems_render.hpp
+ * @brief Compile-time PCM rendering into ROM
+ * @license ISC License
+ *
+ * Short sounds (clicks, chirps, jingles) are cheaper to store as samples than to
+ * synthesise on a busy MCU. render() runs the integer synth (ems_fixed.hpp) at
+ * compile time and returns the samples as a std::array that the linker places in
+ * flash; playback is then a plain DMA transfer. The result is bit-identical to
+ * rendering the same score with ems::fixed::Synth at run time.
+ *
+ * Usage:
+ *   #include "ems_render.hpp"
+ *   using namespace ems::literals;
+ *
+ *   constexpr auto click = "(600)5`.3`."_ems;
+ *   static constexpr auto pcm = ems::render<8000, int8_t, click>(); // std::array<int8_t, 416>
+ *
+ *   dac_dma_start(pcm.data(), pcm.size());
+ *
+ * The melody is a template argument because it decides the array size. Sounds longer
+ * than `MaxBytes` are rejected at compile time; long renders may also need a larger
+ * -fconstexpr-ops-limit (GCC) / -fconstexpr-steps (Clang).
+ */
+
+#ifndef EMS_RENDER_HPP
+#define EMS_RENDER_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "ems_fixed.hpp"
+
+namespace ems
+{
+    /// Default ROM budget of a single render() result.
+    inline constexpr size_t max_render_bytes = 64 * 1024;
+
+    /**
+     * @brief Samples render() produces for a score: every note plus its 1 ms gap.
+     */
+    template <uint32_t SampleRate, size_t N>
+    constexpr size_t rendered_samples(const std::array<Note, N>& melody)
+    {
+        size_t total = 0;
+        for (const auto& n : melody)
+        {
+            total += static_cast<size_t>(static_cast<uint64_t>(n.duration_ms) * SampleRate / 1000) + SampleRate / 1000;
+        }
+        return total;
+    }
+
+    /**
+     * @brief Renders `Melody` to PCM at compile time.
+     * @tparam Sample int16_t, or int8_t (rounded from the 16-bit output) to halve the size.
+     * @tparam MaxBytes Size guard; exceeding it is a compile error.
+     */
+    template <uint32_t SampleRate, typename Sample, auto Melody, size_t MaxBytes = max_render_bytes>
+    consteval auto render()
+    {
+        static_assert(std::is_same_v<Sample, int16_t> || std::is_same_v<Sample, int8_t>,
+                      "ems::render supports int16_t and int8_t samples");
+        constexpr size_t Count = rendered_samples<SampleRate>(Melody);
+        constexpr bool fits = Count * sizeof(Sample) <= MaxBytes;
+        static_assert(fits, "ems::render: sound exceeds the ROM budget (MaxBytes)");
+        if constexpr (!fits) return std::array<Sample, 0>{}; // 不再渲染，只留下上面的断言错误
+        else
+        {
+            constexpr auto score = fixed::compile<SampleRate>(Melody);
+            fixed::Synth<> synth(score.data(), score.size(), SampleRate);
+
+            std::array<Sample, Count> pcm{};
+            if constexpr (std::is_same_v<Sample, int16_t>)
+            {
+                synth.render(pcm.data(), Count);
+            }
+            else
+            {
+                int16_t block[64]{};
+                size_t done = 0;
+                while (const size_t n = synth.render(block, 64))
+                {
+                    for (size_t i = 0; i < n; ++i)
+                    {
+                        // 四舍五入到 8 位
+                        const int32_t v = (block[i] + 128) >> 8;
+                        pcm[done + i] = static_cast<int8_t>(v > 127 ? 127 : v);
+                    }
+                    done += n;
+                }
+            }
+            return pcm;
+        }
+    }
+} // namespace ems
+
+#endif // EMS_RENDER_HPP
@@ -0,0 +1,173 @@
+/**
+ * @file ems_sequencer.hpp
+ * @brief Non-blocking, interrupt-driven EMS playback
+ * @license ISC License
+ *
+ * Replaces the blocking `for (note : melody) { pwm_set(); sleep_ms(); }` loop with a
+ * state machine advanced from a periodic timer interrupt. Each tick is one decrement
+ * and one compare; work is only done at note boundaries, and the main loop keeps
+ * running the whole time.
+ *
+ * Usage:
+ *   #include "ems_sequencer.hpp"
+ *   using namespace ems::literals;
+ *
+ *   constexpr auto melody = "(120)1,2,3,"_ems;
+ *   ems::Sequencer seq(melody.data(), melody.size()); // 1 kHz tick
+ *
+ *   pwm_set(seq.start()->ratio);
+ *
+ *   void SysTick_Handler() {
+ *       if (seq.tick()) pwm_set(seq.finished() ? 0.0f : seq.current()->ratio);
+ *   }
+ *
+ *   // Main loop: other work, with the next note boundary known in advance.
+ *   if (seq.ticks_to_next() > 20) do_slow_work();
+ *
+ * Tickless (battery) use: no periodic interrupt, one wakeup per note boundary.
+ *
+ *   seq.start(rtc_now());
+ *   while (!seq.finished()) {
+ *       rtc_set_alarm(seq.next_deadline());
+ *       deep_sleep();
+ *       if (seq.advance_to(rtc_now())) pwm_set(seq.finished() ? 0.0f : seq.current()->ratio);
+ *   }
+ */
+
+#ifndef EMS_SEQUENCER_HPP
+#define EMS_SEQUENCER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "ems_parser.hpp"
+
+namespace ems
+{
+    /**
+     * @brief Tick-driven cursor over a score.
+     *
+     * `Event` is any type with a `duration_ms` member (Note, Chord<V>, ...). tick() must be
+     * called from a single context (one timer ISR); the query functions may be called from
+     * anywhere, each reads single words only.
+     */
+    template <typename Event = Note>
+    class Sequencer
+    {
+    public:
+        constexpr Sequencer(const Event* events, const size_t count, const uint32_t tick_hz = 1000)
+            : events(events), count(count), tick_hz(tick_hz)
+        {
+        }
+
+        /**
+         * @brief Rewinds to the first event and returns it (nullptr for an empty score).
+         * Call before enabling the timer. `now` sets the time base of now() / next_deadline(),
+         * e.g. the current RTC count for tickless use; it may wrap around.
+         */
+        const Event* start(const uint32_t now = 0)
+        {
+            elapsed.store(now, std::memory_order_relaxed);
+            deadline.store(now, std::memory_order_relaxed);
+            enter(0);
+            return current();
+        }
+
+        /**
+         * @brief Advances by one tick (timer ISR).
+         * @return true on a note boundary: a new event started, or the score finished.
+         */
+        bool tick()
+        {
+            if (finished()) return false;
+
+            elapsed.store(elapsed.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            const uint32_t left = remaining.load(std::memory_order_relaxed) - 1;
+            remaining.store(left, std::memory_order_relaxed);
+            if (left != 0) return false;
+
+            enter(index.load(std::memory_order_relaxed) + 1);
+            return true;
+        }
+
+        /**
+         * @brief Catches up to absolute time `now` (tickless mode, after a one-shot wakeup).
+         * Equivalent to calling tick() until now() == now, but costs O(1) per boundary
+         * crossed rather than per tick.
+         * @return true if at least one note boundary was crossed.
+         */
+        bool advance_to(const uint32_t now)
+        {
+            bool crossed = false;
+            uint32_t delta = now - elapsed.load(std::memory_order_relaxed); // 按模 2^32 计算，允许回绕
+            while (!finished())
+            {
+                const uint32_t left = remaining.load(std::memory_order_relaxed);
+                if (delta < left)
+                {
+                    remaining.store(left - delta, std::memory_order_relaxed);
+                    break;
+                }
+                delta -= left;
+                enter(index.load(std::memory_order_relaxed) + 1);
+                crossed = true;
+            }
+            elapsed.store(now, std::memory_order_relaxed);
+            return crossed;
+        }
+
+        // Event sounding now, nullptr once finished.
+        [[nodiscard]] const Event* current() const
+        {
+            const size_t i = index.load(std::memory_order_acquire);
+            return i < count ? &events[i] : nullptr;
+        }
+
+        [[nodiscard]] bool finished() const { return index.load(std::memory_order_acquire) >= count; }
+        [[nodiscard]] size_t position() const { return index.load(std::memory_order_acquire); }
+
+        // Current time: ticks since start(), plus the time base passed to it.
+        [[nodiscard]] uint32_t now() const { return elapsed.load(std::memory_order_relaxed); }
+
+        // Ticks until the next note boundary (0 once finished).
+        [[nodiscard]] uint32_t ticks_to_next() const { return remaining.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Tick count (on the now() scale) at which the next note boundary occurs.
+         * Stored when the note is entered and read as one word, so it stays consistent
+         * while tick() / advance_to() run in between (now() + ticks_to_next() would mix
+         * two reads); once finished it is the time the score ended.
+         */
+        [[nodiscard]] uint32_t next_deadline() const { return deadline.load(std::memory_order_relaxed); }
+
+    private:
+        constexpr uint32_t ticks_of(const Event& e) const
+        {
+            if (tick_hz == 1000) return e.duration_ms;
+            return static_cast<uint32_t>(static_cast<uint64_t>(e.duration_ms) * tick_hz / 1000);
+        }
+
+        // Starts event `i` at the previous deadline, skipping events shorter than one tick.
+        void enter(size_t i)
+        {
+            uint32_t ticks = 0;
+            while (i < count && (ticks = ticks_of(events[i])) == 0) i++;
+            if (i >= count) ticks = 0;
+            remaining.store(ticks, std::memory_order_relaxed);
+            deadline.store(deadline.load(std::memory_order_relaxed) + ticks, std::memory_order_relaxed);
+            index.store(i, std::memory_order_release);
+        }
+
+        const Event* events;
+        size_t count;
+        uint32_t tick_hz;
+
+        std::atomic<size_t> index{0};
+        std::atomic<uint32_t> remaining{0};
+        std::atomic<uint32_t> elapsed{0};
+        std::atomic<uint32_t> deadline{0}; ///< Absolute end of the current event, on the now() scale.
+    };
+} // namespace ems
+
+#endif // EMS_SEQUENCER_HPP
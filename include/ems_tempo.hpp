@@ -0,0 +1,164 @@
+/**
+ * @file ems_tempo.hpp
+ * @brief Runtime tempo for tick-based EMS scores
+ * @license ISC License
+ *
+ * `_ems_ticks` scores store durations in ticks; TickClock turns a sample count into
+ * ticks at the current tempo. The conversion is exact integer arithmetic (the
+ * fractional tick is carried as a remainder), so a loop can run for hours without
+ * drifting off the beat grid. Changing the tempo is O(1); ramps move it linearly
+ * in small fixed steps.
+ *
+ * Usage:
+ *   #include "ems_tempo.hpp"
+ *   using namespace ems::literals;
+ *
+ *   constexpr auto song = "(120)1,2,3,4,"_ems_ticks;
+ *   ems::TickClock clock(48000, song.bpm);
+ *
+ *   // Per note: samples until the clock reaches the note's end tick.
+ *   const uint64_t end = start_tick + song[i].ticks;
+ *   const uint64_t len = clock.samples_to(end);
+ *   clock.advance(len);
+ *
+ *   clock.ramp_tempo(90.0f, 48000 * 4); // slow down to 90 BPM over four seconds
+ */
+
+#ifndef EMS_TEMPO_HPP
+#define EMS_TEMPO_HPP
+
+#include <cstdint>
+
+#include "ems_parser.hpp"
+
+namespace ems
+{
+    /**
+     * @brief Sample-driven tick counter with tempo changes and linear tempo ramps.
+     * Tempo is kept in milli-BPM; a ramp updates it every `ramp_step` samples.
+     */
+    class TickClock
+    {
+    public:
+        static constexpr uint32_t ramp_step = 64;
+
+        constexpr TickClock(const uint32_t sample_rate, const float bpm, const uint32_t ticks_per_beat = ppq)
+            : rate(sample_rate), ticks_per_beat(ticks_per_beat), mbpm(to_mbpm(bpm)), target(mbpm)
+        {
+        }
+
+        // Takes effect on the next sample and cancels any ramp in progress.
+        constexpr void set_tempo(const float bpm)
+        {
+            mbpm = to_mbpm(bpm);
+            target = mbpm;
+            ramp_left = 0;
+        }
+
+        // Moves the tempo linearly to `bpm` over `samples` samples.
+        constexpr void ramp_tempo(const float bpm, const uint32_t samples)
+        {
+            target = to_mbpm(bpm);
+            ramp_left = samples;
+            ramp_phase = 0;
+            if (samples < ramp_step) set_tempo(bpm);
+        }
+
+        [[nodiscard]] constexpr float tempo() const { return static_cast<float>(mbpm) / 1000.0f; }
+        [[nodiscard]] constexpr uint64_t ticks() const { return tick; }
+        [[nodiscard]] constexpr uint32_t sample_rate() const { return rate; }
+
+        constexpr void advance(uint32_t samples)
+        {
+            while (samples > 0)
+            {
+                const uint32_t n = ramp_left > 0 ? (samples < step_left() ? samples : step_left()) : samples;
+                step(n);
+                samples -= n;
+            }
+        }
+
+        /**
+         * @brief Samples until the clock reaches `target_tick` (0 if already there).
+         * Walks the remaining ramp steps, so it is O(1) outside of ramps.
+         * Returns UINT64_MAX while the tempo is 0.
+         */
+        [[nodiscard]] constexpr uint64_t samples_to(const uint64_t target_tick) const
+        {
+            TickClock c = *this;
+            uint64_t total = 0;
+            while (c.tick < target_tick)
+            {
+                const uint64_t rate_per_sample = static_cast<uint64_t>(c.mbpm) * c.ticks_per_beat;
+                if (c.ramp_left == 0)
+                {
+                    if (rate_per_sample == 0) return UINT64_MAX;
+                    const uint64_t need = (target_tick - c.tick) * c.denominator() - c.frac;
+                    return total + (need + rate_per_sample - 1) / rate_per_sample;
+                }
+
+                const uint32_t n = c.step_left();
+                const uint64_t need = (target_tick - c.tick) * c.denominator() - c.frac;
+                if (rate_per_sample > 0 && need <= rate_per_sample * n)
+                {
+                    return total + (need + rate_per_sample - 1) / rate_per_sample;
+                }
+                c.step(n);
+                total += n;
+            }
+            return total;
+        }
+
+    private:
+        static constexpr uint32_t to_mbpm(const float bpm)
+        {
+            return bpm > 0.0f ? static_cast<uint32_t>(bpm * 1000.0f + 0.5f) : 0;
+        }
+
+        // One tick = 60'000 milli-BPM-minutes * rate samples; frac counts in those units.
+        [[nodiscard]] constexpr uint64_t denominator() const { return uint64_t{60000} * rate; }
+
+        // Samples left before the ramp moves the tempo again.
+        [[nodiscard]] constexpr uint32_t step_left() const
+        {
+            const uint32_t phase = ramp_step - ramp_phase;
+            return phase < ramp_left ? phase : ramp_left;
+        }
+
+        // Advances `n` samples at a constant tempo (n never crosses a ramp step).
+        constexpr void step(const uint32_t n)
+        {
+            frac += static_cast<uint64_t>(mbpm) * ticks_per_beat * n;
+            tick += frac / denominator();
+            frac %= denominator();
+
+            if (ramp_left == 0) return;
+            ramp_left -= n;
+            ramp_phase += n;
+            if (ramp_left == 0)
+            {
+                mbpm = target;
+                ramp_phase = 0;
+            }
+            else if (ramp_phase == ramp_step)
+            {
+                // 每步按剩余距离等分，终点严格等于目标值
+                const int64_t delta = static_cast<int64_t>(target) - mbpm;
+                const int64_t steps = (ramp_left + ramp_step - 1) / ramp_step + 1;
+                mbpm = static_cast<uint32_t>(mbpm + delta / steps);
+                ramp_phase = 0;
+            }
+        }
+
+        uint32_t rate;
+        uint32_t ticks_per_beat;
+        uint32_t mbpm;
+        uint32_t target;
+        uint32_t ramp_left = 0;
+        uint32_t ramp_phase = 0;
+        uint64_t tick = 0;
+        uint64_t frac = 0;
+    };
+} // namespace ems
+
+#endif // EMS_TEMPO_HPP
@@ -0,0 +1,188 @@
+/**
+ * @file ems_timeline.hpp
+ * @brief Compile-time multi-track merging for EMS scores
+ * @license ISC License
+ *
+ * Merges several `_ems` tracks into one flat, time-sorted event list at compile time,
+ * so a player only needs a single cursor no matter how many tracks a song has.
+ *
+ * Usage:
+ *   #include "ems_timeline.hpp"
+ *   using namespace ems::literals;
+ *
+ *   constexpr auto melody = "(120)3,3,4,5,5,4,3,2,"_ems;
+ *   constexpr auto bass   = "(120)`1_`5_`1_`5_"_ems;
+ *   constexpr auto song   = ems::tracks(melody, bass);
+ *
+ *   void play() {
+ *       for (const auto& e : song) {
+ *           wait_until_ms(e.start_ms);
+ *           voice_on(e.track, e.ratio, e.duration_ms);
+ *       }
+ *   }
+ *
+ *   // Seeking: a start-time table built once, binary-searched at runtime.
+ *   constexpr auto index = ems::time_index<48000>(melody); // in frames, as rendered at 48 kHz
+ *   const auto pos = ems::seek(index, 2500 * 48);          // pos.index, pos.offset
+ */
+
+#ifndef EMS_TIMELINE_HPP
+#define EMS_TIMELINE_HPP
+
+#include <array>
+#include <cstdint>
+
+#include "ems_parser.hpp"
+
+namespace ems
+{
+    /**
+     * @brief One note of a merged multi-track score.
+     */
+    struct Event
+    {
+        uint32_t start_ms; ///< Absolute start time from the beginning of the song.
+        uint32_t duration_ms; ///< Duration in milliseconds.
+        float ratio; ///< Frequency ratio (see Note::ratio). 0.0 = Rest.
+        uint8_t track; ///< Index of the source track in the tracks() argument list.
+    };
+
+    /**
+     * @brief Merges tracks into one event array sorted by start time.
+     * Events that start together keep the order of the track arguments.
+     * Rests are kept so every source note maps to exactly one event.
+     */
+    template <size_t... Ns>
+    consteval auto tracks(const std::array<Note, Ns>&... track)
+    {
+        static_assert(sizeof...(Ns) > 0, "ems::tracks needs at least one track");
+        static_assert(sizeof...(Ns) <= 256, "track ids are 8 bit");
+
+        constexpr size_t K = sizeof...(Ns);
+        constexpr size_t Total = (Ns + ... + 0);
+
+        // Flatten every track with its absolute start times.
+        std::array<Event, Total> flat{};
+        std::array<size_t, K + 1> first{};
+        size_t n = 0;
+        uint8_t id = 0;
+        const auto append = [&](const auto& notes)
+        {
+            first[id] = n;
+            uint32_t t = 0;
+            for (const auto& note : notes)
+            {
+                flat[n++] = Event{t, note.duration_ms, note.ratio, id};
+                t += note.duration_ms;
+            }
+            id++;
+        };
+        (append(track), ...);
+        first[K] = n;
+
+        // K-way merge: each track is already sorted, take the earliest head each step.
+        std::array<Event, Total> merged{};
+        std::array<size_t, K> head{};
+        for (size_t k = 0; k < K; ++k) head[k] = first[k];
+
+        for (size_t out = 0; out < Total; ++out)
+        {
+            size_t best = K;
+            for (size_t k = 0; k < K; ++k)
+            {
+                if (head[k] == first[k + 1]) continue;
+                if (best == K || flat[head[k]].start_ms < flat[head[best]].start_ms) best = k;
+            }
+            merged[out] = flat[head[best]++];
+        }
+        return merged;
+    }
+
+    /**
+     * @brief Total length of a merged score in milliseconds (latest event end).
+     */
+    template <size_t N>
+    constexpr uint32_t length_ms(const std::array<Event, N>& events)
+    {
+        uint32_t end = 0;
+        for (const auto& e : events)
+        {
+            end = e.start_ms + e.duration_ms > end ? e.start_ms + e.duration_ms : end;
+        }
+        return end;
+    }
+
+    /// Silence the renderers (generatePCM, PcmStream, ems::render) put after every note.
+    inline constexpr uint32_t note_gap_ms = 1;
+
+    /**
+     * @brief Start times of a score in stream time.
+     * Entry i is where note i starts; the extra last entry is the total length. Every
+     * note occupies its duration plus the note_gap_ms gap, as the renderers lay it out.
+     */
+    template <size_t N>
+    using TimeIndex = std::array<uint32_t, N + 1>;
+
+    // In milliseconds.
+    template <size_t N>
+    consteval TimeIndex<N> time_index(const std::array<Note, N>& notes)
+    {
+        TimeIndex<N> starts{};
+        for (size_t i = 0; i < N; ++i)
+        {
+            starts[i + 1] = starts[i] + notes[i].duration_ms + note_gap_ms;
+        }
+        return starts;
+    }
+
+    /**
+     * @brief In frames at `SampleRate`, rounded per note like the renderers, so a seek
+     * lands on the exact sample at any rate (44.1 kHz included).
+     */
+    template <uint32_t SampleRate, size_t N>
+    consteval TimeIndex<N> time_index(const std::array<Note, N>& notes)
+    {
+        TimeIndex<N> starts{};
+        for (size_t i = 0; i < N; ++i)
+        {
+            const auto samples = static_cast<uint32_t>(static_cast<uint64_t>(notes[i].duration_ms) * SampleRate / 1000);
+            starts[i + 1] = starts[i] + samples + SampleRate * note_gap_ms / 1000;
+        }
+        return starts;
+    }
+
+    /**
+     * @brief Position of a timestamp inside a score.
+     * `index` equals the note count when the time is at or past the end.
+     */
+    struct SeekResult
+    {
+        size_t index; ///< Note playing (or in its trailing gap) at the requested time.
+        uint32_t offset; ///< Time already elapsed inside that note, in the unit of the index.
+    };
+
+    /**
+     * @brief Binary-searches a time index, O(log n). `time` is in the unit of the index.
+     * Zero-length notes are skipped: the result is always the note that is sounding.
+     */
+    template <size_t M>
+    constexpr SeekResult seek(const std::array<uint32_t, M>& starts, const uint32_t time)
+    {
+        static_assert(M > 0, "a time index has at least one entry");
+        constexpr size_t N = M - 1;
+        if (time >= starts[N]) return SeekResult{N, 0};
+
+        // 找到最后一个 starts[i] <= time 的下标
+        size_t lo = 0;
+        size_t hi = N;
+        while (hi - lo > 1)
+        {
+            const size_t mid = lo + (hi - lo) / 2;
+            if (starts[mid] <= time) lo = mid;
+            else hi = mid;
+        }
+        return SeekResult{lo, time - starts[lo]};
+    }
+} // namespace ems
+
+#endif // EMS_TIMELINE_HPP
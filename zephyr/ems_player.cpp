@@ -0,0 +1,133 @@
+#include "ems_player.hpp"
+
+#include <cerrno>
+
+namespace ems::zephyr
+{
+    namespace
+    {
+        uint32_t period_of(const Tone& t) { return t.period_ns; }
+
+        uint32_t period_of(const Note& n)
+        {
+            return n.ratio > 0.0f ? static_cast<uint32_t>(1e9f / (440.0f * n.ratio) + 0.5f) : 0;
+        }
+
+        uint32_t pulse_of(const uint32_t period_ns)
+        {
+            return static_cast<uint32_t>(static_cast<uint64_t>(period_ns) * CONFIG_EMS_PLAYER_DUTY_PERCENT / 100);
+        }
+
+        // 短音符的间隙缩短为时长的一半，保证每个音符都有发声段和间隙
+        constexpr uint32_t gap_of(const uint32_t duration_ms)
+        {
+            const uint32_t half = duration_ms / 2;
+            return CONFIG_EMS_PLAYER_GAP_MS < half ? CONFIG_EMS_PLAYER_GAP_MS : half;
+        }
+    } // namespace
+
+    int Player::init(const pwm_dt_spec& spec)
+    {
+        if (!pwm_is_ready_dt(&spec)) return -ENODEV;
+
+        pwm = &spec;
+        k_timer_init(&timer, &Player::on_expiry, nullptr);
+        k_timer_user_data_set(&timer, this);
+        k_sem_init(&done, 0, 1);
+        return 0;
+    }
+
+    int Player::play(const Event* score, const size_t n)
+    {
+        stop();
+        k_sem_reset(&done);
+
+        events = score;
+        count = n;
+        index = 0;
+        if (count == 0)
+        {
+            k_sem_give(&done);
+            return 0;
+        }
+
+        playing = true;
+        begin_note();
+        return 0;
+    }
+
+    void Player::stop()
+    {
+        k_timer_stop(&timer);
+        if (playing) finish();
+    }
+
+    int Player::wait(const k_timeout_t timeout)
+    {
+        const int ret = k_sem_take(&done, timeout);
+        // 保持信号量可被再次等待，直到下一次 play()
+        if (ret == 0) k_sem_give(&done);
+        return ret;
+    }
+
+    void Player::on_expiry(k_timer* t)
+    {
+        auto* self = static_cast<Player*>(k_timer_user_data_get(t));
+#if defined(CONFIG_EMS_PLAYER_STATS)
+        const uint32_t late = k_cycle_get_32() - self->expected;
+        if (late > self->max_latency && late < 0x80000000u) self->max_latency = late;
+#endif
+        self->advance();
+    }
+
+    // Timer expiry: end of a note's sounding part or of its gap.
+    void Player::advance()
+    {
+        const uint32_t gap = gap_of(events[index].duration_ms);
+        if (phase == Phase::Sound && gap > 0)
+        {
+            pwm_set_pulse_dt(pwm, 0);
+            phase = Phase::Gap;
+            arm(gap);
+            return;
+        }
+
+        if (++index == count)
+        {
+            finish();
+            return;
+        }
+        begin_note();
+    }
+
+    void Player::begin_note()
+    {
+        const Event& e = events[index];
+        const uint32_t period = period_of(e);
+        if (period == 0) pwm_set_pulse_dt(pwm, 0); // 休止符：关闭输出
+        else pwm_set_dt(pwm, period, pulse_of(period));
+
+        phase = Phase::Sound;
+        arm(e.duration_ms - gap_of(e.duration_ms));
+    }
+
+    void Player::arm(const uint32_t ms)
+    {
+#if defined(CONFIG_EMS_PLAYER_STATS)
+        // 以内核实际排定的 tick 为基准，毫秒取整到 tick 的误差不计入延迟
+        const unsigned int key = irq_lock();
+        k_timer_start(&timer, K_MSEC(ms), K_NO_WAIT);
+        expected = static_cast<uint32_t>(k_ticks_to_cyc_floor64(k_timer_expires_ticks(&timer)));
+        irq_unlock(key);
+#else
+        k_timer_start(&timer, K_MSEC(ms), K_NO_WAIT);
+#endif
+    }
+
+    void Player::finish()
+    {
+        pwm_set_pulse_dt(pwm, 0);
+        playing = false;
+        k_sem_give(&done);
+    }
+} // namespace ems::zephyr
@@ -0,0 +1,128 @@
+/**
+ * @file ems_player.hpp
+ * @brief EMS player for Zephyr: PWM output, k_timer timing, no heap
+ * @license ISC License
+ *
+ * Each note programs the PWM period once and arms a one-shot k_timer for its length;
+ * the timer expiry (ISR context) moves on to the next note. Nothing runs between
+ * note boundaries, and the caller's thread is free while the score plays.
+ *
+ * Usage (prj.conf: CONFIG_EMS=y, CONFIG_EMS_PLAYER=y, CONFIG_PWM=y):
+ *   #include "ems_player.hpp"
+ *   using namespace ems::literals;
+ *
+ *   constexpr auto melody = "(120)1,2,3,"_ems;
+ *   static const pwm_dt_spec buzzer = PWM_DT_SPEC_GET(DT_ALIAS(pwm_buzzer));
+ *   static ems::zephyr::Player player;
+ *
+ *   player.init(buzzer);
+ *   player.play(melody.data(), melody.size());   // CONFIG_EMS_PLAYER_ENCODING_NOTE
+ *   player.wait(K_FOREVER);
+ */
+
+#ifndef EMS_ZEPHYR_PLAYER_HPP
+#define EMS_ZEPHYR_PLAYER_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include <zephyr/drivers/pwm.h>
+#include <zephyr/kernel.h>
+
+#include "ems_parser.hpp"
+
+namespace ems::zephyr
+{
+    /**
+     * @brief Precomputed note for CONFIG_EMS_PLAYER_ENCODING_TONE.
+     */
+    struct Tone
+    {
+        uint32_t period_ns; ///< PWM period. 0 = Rest.
+        uint32_t duration_ms; ///< Duration in milliseconds.
+    };
+
+    /**
+     * @brief Converts an `_ems` score to Tones at compile time.
+     */
+    template <size_t N>
+    consteval std::array<Tone, N> encode(const std::array<Note, N>& notes)
+    {
+        std::array<Tone, N> tones{};
+        for (size_t i = 0; i < N; ++i)
+        {
+            const double freq = 440.0 * static_cast<double>(notes[i].ratio);
+            tones[i].period_ns = notes[i].ratio > 0.0f ? static_cast<uint32_t>(1e9 / freq + 0.5) : 0;
+            tones[i].duration_ms = notes[i].duration_ms;
+        }
+        return tones;
+    }
+
+#if defined(CONFIG_EMS_PLAYER_ENCODING_TONE)
+    using Event = Tone;
+#else
+    using Event = Note;
+#endif
+
+    /**
+     * @brief Plays one score at a time on a PWM channel.
+     * The score is referenced, not copied; keep it alive (constexpr / static) while playing.
+     */
+    class Player
+    {
+    public:
+        Player() = default;
+        Player(const Player&) = delete;
+        Player& operator=(const Player&) = delete;
+
+        // Returns 0, or -ENODEV if the PWM device is not ready.
+        int init(const pwm_dt_spec& spec);
+
+        // Stops whatever is playing and starts `events` from the beginning. Returns 0 or a PWM error.
+        int play(const Event* events, size_t count);
+
+        void stop();
+
+        [[nodiscard]] bool busy() const { return playing; }
+
+        // Blocks until the score ends or is stopped. Returns 0, or -EAGAIN on timeout.
+        int wait(k_timeout_t timeout);
+
+#if defined(CONFIG_EMS_PLAYER_STATS)
+        // Worst lateness of a note timer expiry so far, in hardware cycles, counted from the
+        // system tick the timer was scheduled on (rounding note lengths up to ticks is not included).
+        [[nodiscard]] uint32_t max_latency_cycles() const { return max_latency; }
+#endif
+
+    private:
+        enum class Phase : uint8_t
+        {
+            Sound,
+            Gap,
+        };
+
+        static void on_expiry(k_timer* timer);
+        void advance();
+        void begin_note();
+        void arm(uint32_t ms);
+        void finish();
+
+        const pwm_dt_spec* pwm = nullptr;
+        k_timer timer{};
+        k_sem done{};
+
+        const Event* events = nullptr;
+        size_t count = 0;
+        size_t index = 0;
+        Phase phase = Phase::Sound;
+        volatile bool playing = false;
+
+#if defined(CONFIG_EMS_PLAYER_STATS)
+        uint32_t expected = 0; ///< Cycle count of the tick the armed timer expires on.
+        uint32_t max_latency = 0;
+#endif
+    };
+} // namespace ems::zephyr
+
+#endif // EMS_ZEPHYR_PLAYER_HPP
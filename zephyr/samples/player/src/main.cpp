@@ -0,0 +1,45 @@
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+
+#include "ems_player.hpp"
+using namespace ems::literals;
+
+constexpr auto melody = "(160)1,2,3,1,1,2,3,1,3,4,5_3,4,5_"_ems;
+
+#if defined(CONFIG_EMS_PLAYER_ENCODING_TONE)
+constexpr auto score = ems::zephyr::encode(melody);
+#else
+constexpr const auto& score = melody;
+#endif
+
+static const pwm_dt_spec buzzer = PWM_DT_SPEC_GET(DT_ALIAS(pwm_buzzer));
+static ems::zephyr::Player player;
+
+int main()
+{
+    if (player.init(buzzer) != 0)
+    {
+        printk("ems_player: PWM device not ready\n");
+        return 0;
+    }
+
+    uint32_t scoreMs = 0;
+    for (const auto& n : melody) scoreMs += n.duration_ms;
+
+    printk("ems_player: playing %u notes\n", static_cast<unsigned>(score.size()));
+    const int64_t start = k_uptime_get();
+    player.play(score.data(), score.size());
+    player.wait(K_FOREVER);
+    const int64_t elapsed = k_uptime_get() - start;
+
+    printk("ems_player: finished in %u ms (score %u ms)\n", static_cast<unsigned>(elapsed), scoreMs);
+    // 从排定的 tick 算起，不含毫秒到 tick 的取整
+    printk("ems_player: max timer latency %u cycles after the scheduled tick\n", player.max_latency_cycles());
+
+    // 只是调用 play()/wait() 的 main 线程；播放器本身在定时器中断里运行，使用中断栈
+    size_t unused = 0;
+    k_thread_stack_space_get(k_current_get(), &unused);
+    printk("ems_player: main thread stack used %u of %u bytes (player runs on the ISR stack)\n",
+           static_cast<unsigned>(CONFIG_MAIN_STACK_SIZE - unused), static_cast<unsigned>(CONFIG_MAIN_STACK_SIZE));
+    return 0;
+}